@@ -4,6 +4,8 @@
 #include "CollisionGrid.hpp"
 #include "Quadtree.hpp"
 #include "AggregationManager.hpp"
+#include "Region.hpp"
+#include "RegionIndex.hpp"
 
 class AdaptiveGridBasedSensor : public Sensor {
 
@@ -21,7 +23,7 @@ public:
     // Base constructor for simulation
     AdaptiveGridBasedSensor(
         float frameRate, 
-        sf::FloatRect detectionArea, 
+        sim::FloatRect detectionArea, 
         float cellSize, 
         int maxDepth, 
         const std::string& databaseName, 
@@ -32,8 +34,8 @@ public:
 
     // Alternative constructor for rendering
     AdaptiveGridBasedSensor(
-        sf::FloatRect detectionArea, 
-        sf::Color detectionAreaColor, 
+        sim::FloatRect detectionArea, 
+        sim::Color detectionAreaColor, 
         float cellSize,
         int maxDepth,
         bool showGrid,
@@ -45,22 +47,60 @@ public:
     bool showGrid = false;
     int maxDepth;
     Quadtree adaptiveGrid;
-    sf::Vector2f position = sf::Vector2f(detectionArea.position.x, detectionArea.position.y);
+    sim::Vector2f position = sim::Vector2f(detectionArea.position.x, detectionArea.position.y);
+
+    // Split mode: "occupancy" splits to maxDepth wherever agents are, "privacy" only keeps
+    // splits whose children satisfy the privacy and spatial granularity bounds of their region
+    std::string splitMode = "occupancy";
     
-    // void update(std::vector<Agent>& agents, float timeStep, sf::Time simulationTime, std::string date) override;
-    void update(std::vector<Agent>& agents, float timeStep, std::chrono::system_clock::time_point timestamp) override;
+    // void update(std::vector<Agent>& agents, float timeStep, sim::Time simulationTime, std::string date) override;
+    void update(std::vector<Agent>& agents, const SimulationClock& clock) override;
     void postData() override;
     void postMetadata() override;
     void printData() override;
     void clearDatabase() override;
     void calculateCellDensity();
+    AggregationManager& getAggregationManager() { return aggregationManager; }
+
+    // Precompute the privacy and granularity bounds of all cells from the region index
+    void setRegionIndex(RegionIndex& regionIndex, const std::vector<Region>& regions);
 
 private:
+    // Privacy constraints of a cell (most restrictive of all regions it overlaps)
+    struct CellConstraints {
+        int kAnonymity = 1;
+        int lDiversity = 1;
+        float minCellSize = 0.0f;
+        float minWindow = 0.0f; // Temporal granularity bounds in seconds (coarsest of all regions)
+        float maxWindow = 0.0f;
+    };
+
+    // Per-node counts of the bottom-up privacy pass
+    struct PrivacyNodeStats {
+        int totalAgents = 0;
+        uint64_t agentTypeMask = 0; // One bit per agent type
+        bool childrenCompliant = true;
+    };
+
+    std::unordered_set<int> computePrivacyConstrainedCells();
+    CellConstraints getCellConstraints(int cellId) const;
+    uint64_t getAgentTypeBit(const std::string& agentType);
+
     mongocxx::database db;
     mongocxx::collection collection;
     AggregationManager aggregationManager;
     AdaptiveGridData adaptiveGridData;
+    std::unordered_map<int, std::vector<uint64_t>> cellAgentHashes; // Agent id hashes per cell (approximate aggregation)
     SharedBuffer<sensorBufferFrameType>& sensorBuffer;
     sensorFrame currentCellIds;
     std::vector<std::pair<std::chrono::system_clock::time_point, AdaptiveGridData>> dataStorage; // Data Storage: timestamp, map(cell id, map(agent type, count)
+
+    // Privacy split state (reused between frames)
+    std::vector<std::pair<uint32_t, uint64_t>> privacyKeys; // Leaf Morton key, agent type bit
+    std::unordered_map<int, PrivacyNodeStats> privacyNodeStats;
+    std::unordered_map<std::string, int> agentTypeBits;
+
+    // Region bounds per cell: Morton-indexed region sets and the constraints of each set
+    RegionIndex::CellTable regionCells;
+    std::vector<CellConstraints> regionSetConstraints;
 };
\ No newline at end of file
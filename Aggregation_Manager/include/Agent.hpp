@@ -1,6 +1,5 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -8,9 +7,16 @@
 #include <cmath>
 #include <uuid/uuid.h>
 
+#include "SimTypes.hpp"
+#include "AgentHandle.hpp"
 #include "PerlinNoise.hpp"
+#include "Trajectory.hpp"
 #include "Logging.hpp"
 
+class CheckpointWriter;
+class CheckpointReader;
+class SpatialQuery;
+
 /*********************************/
 /********** AGENT CLASS **********/
 /*********************************/
@@ -38,76 +44,89 @@ public:
             float max;
         } acceleration;
         float lookAheadTime;
+        float spawnRate = 0.0f; // Agents per second in the continuous scenario
     };
 
     Agent(const AgentTypeAttributes& attributes);
-    ~Agent();
+    void reset(const AgentTypeAttributes& attributes);
 
     // Position
     void calculateTrajectory(float waypointDistance);
     void getNextWaypoint();
     void updatePosition(float deltaTime);
-    sf::Vector2f getFuturePositionAtTime(float time) const;
+    sim::Vector2f getFuturePositionAtTime(float time) const;
 
     // Velocity
-    void calculateVelocity(sf::Vector2f waypoint);
-    void updateVelocity(float deltaTime, sf::Time simulationTime);
+    void calculateVelocity(sim::Vector2f waypoint);
+    void updateVelocity(const PerlinNoise& noise, sim::Time simulationTime);
+    void applyVelocityNoise(float noiseX, float noiseY);
 
     // States
     void stop();
-    bool canResume(const std::vector<Agent>& agents);
-    void resume(const std::vector<Agent>& agents);
+    bool canResume(const SpatialQuery& neighbours) const;
+    void resume(const SpatialQuery& neighbours);
+    void resume();
     void resetCollisionState();
     void setBufferZoneSize();
-    sf::FloatRect getBufferZoneBounds() const;
+    sim::FloatRect getBufferZoneBounds() const;
+
+    // Checkpoint of the complete agent state
+    void save(CheckpointWriter& writer) const;
+    void load(CheckpointReader& reader);
 
     // Agent features
+    AgentHandle handle; // Stable reference into the simulation's agent vector
     std::string agentId;
     std::string sensorId;
     std::string type;
-    sf::Color color;
-    sf::Color initialColor;
+    sim::Color color;
+    sim::Color initialColor;
     int priority;
     float bodyRadius;
     AgentTypeAttributes attributes;
     std::chrono::system_clock::time_point timestamp;
 
     // Positions
-    sf::Vector2f position;
-    sf::Vector2f initialPosition;
-    sf::Vector2f targetPosition;
-    sf::Vector2f heading;
+    sim::Vector2f position;
+    sim::Vector2f initialPosition;
+    sim::Vector2f targetPosition;
+    sim::Vector2f heading;
     float theta;
 
     // Velocity
-    sf::Vector2f velocity;
-    sf::Vector2f initialVelocity;
+    sim::Vector2f velocity;
+    sim::Vector2f initialVelocity;
     float velocityMagnitude;
 
     // Acceleration
-    sf::Vector2f acceleration;
-    sf::Vector2f initialAcceleration;
+    sim::Vector2f acceleration;
+    sim::Vector2f initialAcceleration;
     float accelerationMagnitude;
 
     // Trajectory
-    std::vector<sf::Vector2f>(trajectory);
+    Trajectory trajectory; // Straight routes are procedural, only routed paths store waypoints
     float waypointDistance;
-    // sf::Color waypointColor;
+    // sim::Color waypointColor;
     int nextWaypointIndex = -1;
 
     // Visuals
     float bufferZoneRadius;
     float minBufferZoneRadius;
-    sf::Color bufferZoneColor;
+    sim::Color bufferZoneColor;
 
     // States
     bool collisionPredicted;
     bool stopped;
-    bool isActive;
-    int stoppedFrameCounter;
+    bool isActive;           // Awake, sleeping agents are skipped by the update until woken
+    int stoppedFrameCounter; // Consecutive frames that started with the agent stopped
+    bool isBackground;       // Outside every observed area: coarse steps without noise and collision checks
+    uint64_t lastUpdateTick = 0; // Tick of the last position update, background agents lag behind
+    uint64_t wakeTick = 0;       // Tick at which a sleeping agent checks its way, matches its entry in the sleep queue
     float lookAheadTime;
 
-    // Perlin noise
-    unsigned int noiseSeed;
-    PerlinNoise perlinNoise;  // TODO: Change to simplex noise -> Huge savings in performance
+    // Noise offset of the agent in the shared noise field (time axis)
+    float noiseOffset = 0.0f;
+
+private:
+    void resetState();
 };
\ No newline at end of file
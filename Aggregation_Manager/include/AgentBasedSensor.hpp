@@ -2,6 +2,7 @@
 #include <chrono>
 
 #include "Sensor.hpp"
+#include "PrivacyMetrics.hpp"
 
 class AgentBasedSensor : public Sensor {
 public:
@@ -13,14 +14,14 @@ public:
         std::string agentId;
         std::chrono::system_clock::time_point timestamp;
         std::string type;
-        sf::Vector2f position;
-        sf::Vector2f estimatedVelocity;
+        sim::Vector2f position;
+        sim::Vector2f estimatedVelocity;
     };
 
     // Base constructor for simulation
     AgentBasedSensor(
         float frameRate, 
-        sf::FloatRect detectionArea, 
+        sim::FloatRect detectionArea, 
         const std::string& databaseName,
         const std::string& collectionName,
         std::shared_ptr<mongocxx::client> client,
@@ -29,15 +30,16 @@ public:
 
     // Alternative constructor for rendering
     AgentBasedSensor( 
-        sf::FloatRect detectionArea, 
-        sf::Color detectionAreaColor,
+        sim::FloatRect detectionArea, 
+        sim::Color detectionAreaColor,
         SharedBuffer<sensorBufferFrameType>& sensorBuffer
     );
 
     ~AgentBasedSensor();
-    sf::Vector2f position = sf::Vector2f(detectionArea.position.x, detectionArea.position.y);
+    sim::Vector2f position = sim::Vector2f(detectionArea.position.x, detectionArea.position.y);
+    std::unique_ptr<PrivacyMetrics> privacyMetrics; // Optional online privacy metrics of the captured data
 
-    void update(std::vector<Agent>& agents, float timeStep, std::chrono::system_clock::time_point timestamp) override;
+    void update(std::vector<Agent>& agents, const SimulationClock& clock) override;
     void captureAgentData(std::vector<Agent>& agents);
     void postData() override;
     void postMetadata() override;
@@ -49,7 +51,7 @@ private:
     mongocxx::collection collection;
 
     // Mapping of agent ID to estimated velocity
-    std::unordered_map<std::string, sf::Vector2f> estimatedVelocities;
+    std::unordered_map<std::string, sim::Vector2f> estimatedVelocities;
 
     // Data storage structure
     std::vector<AgentData> agentData;
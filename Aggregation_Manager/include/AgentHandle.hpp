@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class CheckpointWriter;
+class CheckpointReader;
+
+/*
+
+Generation-checked handles to agents stored in a dense vector
+
+Agents are removed by swap-and-pop, so their index in the vector changes. A handle
+names a slot of the table, which stores the agent's current index and a generation.
+Releasing a slot increments its generation, so handles to removed agents resolve to
+-1 instead of to whichever agent took their place.
+
+*/
+
+struct AgentHandle {
+    static constexpr uint32_t invalidSlot = 0xFFFFFFFFu;
+
+    uint32_t slot = invalidSlot;
+    uint32_t generation = 0;
+
+    bool valid() const { return slot != invalidSlot; }
+    bool operator==(const AgentHandle& other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const AgentHandle& other) const { return !(*this == other); }
+};
+
+class AgentHandleTable {
+public:
+    // Handle to an agent at an index (reuses released slots)
+    AgentHandle create(uint32_t index);
+
+    // Invalidate a handle, its slot is reused with the next generation
+    void release(AgentHandle handle);
+
+    // Update the index of an agent that was moved in the vector
+    void relocate(AgentHandle handle, uint32_t index);
+
+    // Current index of an agent, -1 if the handle is stale
+    int getIndex(AgentHandle handle) const;
+
+    void clear();
+    size_t size() const { return slots.size() - freeSlots.size(); }
+
+    // Checkpoint of the slots, so that handles stay valid after a restore
+    void save(CheckpointWriter& writer) const;
+    void load(CheckpointReader& reader);
+
+private:
+    struct Slot {
+        uint32_t index;
+        uint32_t generation;
+        bool alive;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+};
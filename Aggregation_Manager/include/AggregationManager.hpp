@@ -1,11 +1,14 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <unordered_map>
 #include <yaml-cpp/yaml.h>
 #include <chrono>
 #include <string>
 #include <set>
+#include <map>
+#include <memory>
 #include <iostream>
 #include <mongocxx/client.hpp>
 #include <mongocxx/database.hpp>
@@ -19,12 +22,36 @@
 #include "Agent.hpp"
 #include "Utilities.hpp"
 #include "Quadtree.hpp"
+#include "RollupCube.hpp"
+#include "Sketches.hpp"
+#include "AsyncWriter.hpp"
+
+/*
+
+Streaming spatio-temporal aggregation of adaptive grid cells
+
+Every sensor frame adds its per-cell counts to the current pane of the cell. A pane
+is one window hop long; a window is the sum of the panes it spans. Windows are
+aligned to multiples of the hop, so with hop == length they are tumbling windows,
+with hop < length sliding windows. Closed windows are written to the sensor's
+collection as "aggregated adaptive grid data". Optionally every frame is also added to
+a roll-up cube for multi-resolution queries, which is saved next to the leaf stream.
+
+In the approximate mode the per-type counts of all cells of a pane go into one shared
+Count-Min sketch and every pane keeps a HyperLogLog of the distinct agents of the cell,
+so memory only depends on the sketch sizes and the number of open panes.
+
+The next window end of every cell is scheduled on a timer wheel keyed on simulation
+time, so each update only touches the cells with a window due. Panes are recycled
+through a pool and closed windows can be handed in batches to an asynchronous writer.
+
+*/
 
 class AggregationManager {
 public:
     AggregationManager(
-        mongocxx::collection& collection, 
-        const std::string& sensorId, 
+        mongocxx::collection& collection,
+        const std::string& sensorId,
         std::chrono::system_clock::time_point& timestamp
     );
 
@@ -37,38 +64,148 @@ public:
         std::string regionType;
         std::vector<int> cellPosition;
         std::unordered_map<std::string, int> agentTypeCount;
-        int totalAgents;
+        int totalAgents = 0;
         float privacyLevel;
         std::unordered_map<std::string, float> privacyMetrics; // Make privacy metrics struct
     };
 
+    // One pane of a cell: counts accumulated over [aggregationStartTime, aggregationEndTime)
     struct AggregatedGridDataBucket {
         int cellId;
-        std::unordered_map<int, AggregatedGridData> aggregatedData;
+        AggregatedGridData aggregatedData;
+        int frameCount = 0;
+        uint64_t agentTypeMask = 0;  // Approximate mode: types counted in the pane sketch
+        HyperLogLog distinctAgents;  // Approximate mode: distinct agents of the pane
         std::chrono::system_clock::time_point timestamp;  // For when data is sent
-        std::chrono::system_clock::duration aggregationDuration; 
+        std::chrono::system_clock::duration aggregationDuration;
         std::chrono::system_clock::time_point aggregationStartTime;
         std::chrono::system_clock::time_point aggregationEndTime;
 
         AggregatedGridDataBucket(int cellId)
-            : aggregationStartTime() {}
+            : cellId(cellId), aggregationStartTime() {}
 
-        void reset() {
-            aggregatedData.clear();
+        // Add the counts of one sensor frame
+        void add(const std::unordered_map<std::string, int>& agentTypeCount, int totalAgents) {
+            for (const auto& [agentType, count] : agentTypeCount) {
+                aggregatedData.agentTypeCount[agentType] += count;
+            }
+            aggregatedData.totalAgents += totalAgents;
+            frameCount++;
+        }
+
+        // Add the counts of another bucket (pane) of the same cell
+        void merge(const AggregatedGridDataBucket& other) {
+            for (const auto& [agentType, count] : other.aggregatedData.agentTypeCount) {
+                aggregatedData.agentTypeCount[agentType] += count;
+            }
+            aggregatedData.totalAgents += other.aggregatedData.totalAgents;
+            frameCount += other.frameCount;
+            agentTypeMask |= other.agentTypeMask;
+            distinctAgents.merge(other.distinctAgents);
         }
 
-        void flush() {
-            
+        void reset() {
+            aggregatedData.agentTypeCount.clear();
+            aggregatedData.totalAgents = 0;
+            frameCount = 0;
+            agentTypeMask = 0;
+            distinctAgents.clear();
         }
+
+        // Append the window document of this bucket to a bulk insert
+        void flush(const std::string& sensorId, std::vector<bsoncxx::document::value>& documents) const;
+    };
+
+    // Window configuration and open panes of one cell
+    struct CellWindows {
+        std::chrono::milliseconds windowLength;
+        std::chrono::milliseconds windowHop;
+        std::chrono::system_clock::time_point nextWindowEnd;
+        std::deque<AggregatedGridDataBucket> panes; // Ordered by start time
     };
 
+    // Add the counts of one cell for the current frame (window length and hop in seconds),
+    // the agent id hashes are only used for the distinct agents of the approximate mode
+    void ingest(int cellId, const std::unordered_map<std::string, int>& agentTypeCount, int totalAgents, float windowLength, float windowHop,
+                const std::vector<uint64_t>* agentHashes = nullptr);
+
+    // Close and emit all windows that ended at the current timestamp
+    void update();
+
+    // Emit all open windows, also partial ones (end of simulation)
+    void flush();
+
     void postDataTest();
 
+    // Insert closed windows from a writer thread with its own client instead of the simulation thread
+    void startAsyncWriter(const std::string& uri, const std::string& databaseName, const std::string& collectionName);
+
+    bool enabled = false;
+    float defaultWindowLength = 10.0f; // Seconds, used outside of any region
+    float defaultWindowHop = 0.0f;     // Seconds, 0 for tumbling windows
+
+    // Approximate mode with Count-Min (epsilon, delta) and HyperLogLog (precision) sketches
+    bool approximate = false;
+    double sketchEpsilon = 0.001;
+    double sketchDelta = 0.01;
+    int sketchPrecision = 10;
+
+    // Roll-up of all ingested counts over the quadtree and time
+    bool rollupEnabled = false;
+    std::string rollupOutput; // Binary file written on destruction, empty to keep in memory only
+    RollupCube rollupCube;
+
 private:
-    // sf::Time& simulationTime;
+    // Approximate mode: Count-Min sketch of one pane (start, hop) shared by all cells
+    struct PaneSketch {
+        CountMinSketch sketch;
+        int numPanes = 0; // Open panes referring to the sketch
+    };
+
+    // Timer wheel entry of a cell's next window end
+    struct WheelEntry {
+        int cellId;
+        int64_t dueTick;
+    };
+
+    void closeWindows(CellWindows& cellWindows, std::chrono::system_clock::time_point until, std::vector<bsoncxx::document::value>& documents);
+    void dropFrontPane(CellWindows& cellWindows);
+    void schedule(int cellId, const CellWindows& cellWindows);
+    void postDocuments(std::vector<bsoncxx::document::value>& documents);
+    AggregatedGridDataBucket acquireBucket(int cellId);
+    void releaseBucket(AggregatedGridDataBucket&& bucket);
+    CountMinSketch& getPaneSketch(const AggregatedGridDataBucket& pane);
+    void addPaneEstimates(AggregatedGridDataBucket& window, const AggregatedGridDataBucket& pane) const;
+    static std::pair<int64_t, int64_t> getPaneKey(const AggregatedGridDataBucket& pane);
+    int getAgentTypeIndex(const std::string& agentType);
+
+    // Sketch key of a cell and agent type index (0xFF for the total agents)
+    static uint64_t makeSketchKey(int cellId, int typeIndex) { return (static_cast<uint64_t>(cellId) << 8) | static_cast<uint64_t>(typeIndex); }
+    static constexpr int totalIndex = 0xFF;
+
+    // sim::Time& simulationTime;
     // std::string datetime;
     std::chrono::system_clock::time_point& timestamp;
     mongocxx::collection& collection;
     std::string sensorId;
-    std::unordered_map<int, AggregationManager::AggregatedGridDataBucket> aggregatedGridDataBuckets; // Grid Data: map(cell id, map(agent type, count)
-};
\ No newline at end of file
+    std::unordered_map<int, CellWindows> aggregatedGridDataBuckets; // Open panes per cell id
+
+    // Approximate mode: one Count-Min sketch per pane (start, hop in milliseconds) shared by all cells
+    std::map<std::pair<int64_t, int64_t>, PaneSketch> paneSketches;
+    std::vector<CountMinSketch> sketchPool;
+    std::vector<std::string> agentTypes;
+    std::unordered_map<std::string, int> agentTypeIndices;
+
+    // Timer wheel over simulation time, one slot per tick, entries of later rounds stay in their slot
+    static constexpr int64_t wheelTickMs = 50;
+    static constexpr size_t wheelSize = 1024;
+    std::vector<std::vector<WheelEntry>> wheel = std::vector<std::vector<WheelEntry>>(wheelSize);
+    int64_t wheelTick = -1; // Last processed tick
+    std::vector<WheelEntry> dueEntries;
+
+    // Recycled panes and the window bucket reused for every closed window
+    std::vector<AggregatedGridDataBucket> bucketPool;
+    AggregatedGridDataBucket windowBucket{0};
+
+    std::unique_ptr<AsyncWriter> writer;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/uri.hpp>
+#include <bsoncxx/builder/stream/document.hpp>
+
+#include "Logging.hpp"
+
+/*
+
+Asynchronous batched writer for one MongoDB collection
+
+Batches of documents are queued by the simulation thread and bulk-inserted by a
+writer thread with its own client (mongocxx clients are not thread-safe). Stopping
+the writer inserts all batches still queued.
+
+*/
+
+class AsyncWriter {
+public:
+    AsyncWriter(const std::string& uri, const std::string& databaseName, const std::string& collectionName);
+    ~AsyncWriter();
+
+    // Queue a batch of documents for a bulk insert (the batch is moved from)
+    void submit(std::vector<bsoncxx::document::value>&& documents);
+
+    // Insert all queued batches and stop the writer thread
+    void stop();
+
+private:
+    void run();
+
+    std::string uri;
+    std::string databaseName;
+    std::string collectionName;
+
+    std::deque<std::vector<bsoncxx::document::value>> batches;
+    std::mutex queueMutex;
+    std::condition_variable queueCond;
+    bool stopped = false;
+    std::thread worker;
+};
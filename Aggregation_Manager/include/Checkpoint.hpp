@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Logging.hpp"
+
+/*
+
+Versioned binary checkpoint files
+
+A checkpoint starts with the magic "SCKP" and a format version, followed by the
+sections written by the simulation (clock, random streams, agents, sensors). Values
+are written in the byte order of the machine; trivially copyable values (numbers,
+vectors, colors, random generator states) are written as raw bytes, strings and
+vectors with a length prefix. The reader rejects other magics and newer versions, so
+formats can be extended by bumping the version and branching on getVersion().
+Writers and readers on a caller's stream skip the header; they serialize agents for
+messages between processes.
+
+*/
+
+namespace Checkpoint {
+
+constexpr uint32_t version = 2; // 2: tick of the last agent update (level of detail)
+
+} // namespace Checkpoint
+
+class CheckpointWriter {
+public:
+    // Open a file and write the header
+    explicit CheckpointWriter(const std::string& path);
+
+    // Write to a stream without a header (e.g. a message buffer)
+    explicit CheckpointWriter(std::ostream& stream) : file(stream) {}
+
+    bool good() const { return static_cast<bool>(file); }
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values are written as bytes");
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void write(const std::string& value);
+
+    template <typename T>
+    void write(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only vectors of trivially copyable values are written as bytes");
+        write(static_cast<uint64_t>(values.size()));
+        file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    void write(const std::unordered_map<std::string, T>& values) {
+        write(static_cast<uint64_t>(values.size()));
+        for (const auto& [key, value] : values) {
+            write(key);
+            write(value);
+        }
+    }
+
+private:
+    std::ofstream fileStream;
+    std::ostream& file;
+};
+
+class CheckpointReader {
+public:
+    // Open a file and check the header
+    explicit CheckpointReader(const std::string& path);
+
+    // Read from a stream without a header, in the current format
+    explicit CheckpointReader(std::istream& stream);
+
+    bool good() const { return valid && static_cast<bool>(file); }
+    uint32_t getVersion() const { return version; }
+
+    template <typename T>
+    void read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values are read as bytes");
+        file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    void read(std::string& value);
+
+    template <typename T>
+    void read(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only vectors of trivially copyable values are read as bytes");
+        uint64_t size = readSize();
+        values.resize(size);
+        file.read(reinterpret_cast<char*>(values.data()), size * sizeof(T));
+    }
+
+    template <typename T>
+    void read(std::unordered_map<std::string, T>& values) {
+        uint64_t size = readSize();
+        values.clear();
+        values.reserve(size);
+        for (uint64_t i = 0; i < size && file; ++i) {
+            std::string key;
+            read(key);
+            read(values[key]);
+        }
+    }
+
+    // Length prefix, 0 (and a failed stream) if it exceeds the remaining bytes
+    uint64_t readSize();
+
+private:
+    std::ifstream fileStream;
+    std::istream& file;
+    uint64_t fileSize = 0;
+    uint32_t version = 0;
+    bool valid = false;
+};
@@ -2,13 +2,16 @@
 
 #include "../include/Agent.hpp"
 #include "../include/Obstacle.hpp"
+#include "../include/ObstacleIndex.hpp"
+#include "../include/SpatialQuery.hpp"
 
 // Function declaration
 bool predictCollisionAgents_v1(Agent& agent1, Agent& agent2);
 bool predictCollisionAgents_v2(Agent& agent1, Agent& agent2);
 bool predictCollisionAgents(Agent& agent1, Agent& agent2);
-// bool predictCollisionObstacle(Agent& agent, const std::vector<Obstacle>& obstacles);
+bool predictCollisionObstacle(Agent& agent, const ObstacleIndex& obstacles);
+void stopBeforeObstacle(Agent& agent);
 bool agentAgentCollision(Agent& agent1, Agent& agent2);
-bool agentAgentsCollision(Agent& agent, std::vector<Agent>& agents);
-// bool agentObstaclesCollision(Agent& agent, const std::vector<Obstacle>& obstacles);
+bool agentAgentsCollision(const Agent& agent, const SpatialQuery& neighbours);
+bool agentObstaclesCollision(Agent& agent, const ObstacleIndex& obstacles);
 bool collisionPossible(Agent& agent1, Agent& agent2);
\ No newline at end of file
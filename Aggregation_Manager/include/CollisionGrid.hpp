@@ -1,14 +1,17 @@
 #pragma once
 
-#include <SFML/System/Vector2.hpp>
+#include <array>
 #include <unordered_map>
 #include <vector>
+#include "SimTypes.hpp"
 #include "Agent.hpp" // Assuming your Agent class is defined in Agent.hpp
 #include "Utilities.hpp"
 
 // GridCell structure for storing agents in each cell
 struct GridCell {
     std::vector<Agent*> agents;
+    std::vector<Agent*> ghosts; // Read-only copies of agents owned by another tile
+    std::vector<Agent*> statics; // Agents not moved this frame (asleep or in the background), only seen by queries
     float cellDensity = 0.0f;
     int totalAgents = 0;
 };
@@ -16,25 +19,34 @@ struct GridCell {
 class Grid {
 public:
     // Grid(float cellSize, int width, int height); // in cells
-    Grid(float cellSize, sf::FloatRect detectionArea); // in cells
-    sf::Vector2i addAgent(Agent* agent);
+    Grid(float cellSize, sim::FloatRect detectionArea); // in cells
+    sim::Vector2i addAgent(Agent* agent);
+    sim::Vector2i addGhost(Agent* ghost);
+    sim::Vector2i addStatic(Agent* agent);
     void clear();
     void calculateDensity(); // Calculate agent density in each cell
     void checkCollisions(); // Handle collision checks within the grid
-    sf::Vector2i getGridCellIndex(const sf::Vector2f& position); // Function to get grid cell index based on position
-    std::unordered_map<sf::Vector2i, GridCell, Vector2iHash> cells; 
+    sim::Vector2i getGridCellIndex(const sim::Vector2f& position) const; // Function to get grid cell index based on position
+    std::unordered_map<sim::Vector2i, GridCell, Vector2iHash> cells; 
 
     // Accessor function for cells (now returns non-const reference)
-    std::unordered_map<sf::Vector2i, GridCell, Vector2iHash>& getCells() {  
+    std::unordered_map<sim::Vector2i, GridCell, Vector2iHash>& getCells() {  
         return cells; 
     }
     int width; // Number of cells horizontally
     int height; // Number of cells vertically
     float cellSize;
+    float maxAgentRadius = 0.0f; // Largest body or buffer zone radius added since the last clear
 
 private:
-    sf::FloatRect detectionArea;
+    sim::FloatRect detectionArea;
+
+    // Check the agents of a cell against the ghosts of a cell
+    void checkGhostCollisions(const GridCell& cell, const GridCell& ghostCell);
 
     // Helper function to get adjacent cell indices
-    std::vector<sf::Vector2i> getAdjacentCellIndices(const sf::Vector2i& cellIndex) const;
+    std::vector<sim::Vector2i> getAdjacentCellIndices(const sim::Vector2i& cellIndex) const;
+
+    // Adjacent cells after a cell, visiting them from every cell covers each pair of cells once
+    std::array<sim::Vector2i, 4> getForwardCellIndices(const sim::Vector2i& cellIndex) const;
 };
\ No newline at end of file
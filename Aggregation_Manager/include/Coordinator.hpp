@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+#include "Distributed.hpp"
+#include "Socket.hpp"
+
+/*
+
+Coordinator of a distributed run
+
+Accepts one connection per rank, then holds every frame until all ranks reported it
+(the frame barrier) and lets them continue. The ranks' statistics are summed into
+the global population and migration counts. If a rank fails or stops early, the
+remaining ranks are stopped.
+
+*/
+
+class Coordinator {
+public:
+    Coordinator(const YAML::Node& config);
+
+    // Run the frame barriers until all ranks finished, false if a rank failed
+    bool run();
+
+private:
+    bool acceptRanks();
+    void stopRanks();
+
+    Distributed::Settings settings;
+    std::vector<Socket> ranks;
+};
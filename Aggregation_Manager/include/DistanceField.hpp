@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "Obstacle.hpp"
+
+/*
+
+Signed distance field of the obstacles
+
+The signed distance to the nearest obstacle (negative inside) is rasterized once on a
+regular grid of nodes around the obstacles, rectangles and polygons alike. Distances
+are truncated at a maximum distance, which bounds the rasterization to a band around
+every obstacle; points outside the field are at least that far from any obstacle.
+
+Lookups interpolate the four surrounding nodes bilinearly, so the clearance of a point
+and its gradient (the direction away from the nearest obstacle, for repulsion) cost
+O(1) regardless of the number of obstacles. The interpolated distance differs from the
+exact one by at most the node diagonal, getClearance subtracts it for a safe bound.
+
+*/
+
+class DistanceField {
+public:
+
+    // Rasterize the obstacles with a node spacing (meters), distances truncated at maxDistance
+    void build(const std::vector<Obstacle>& obstacles, float resolution, float maxDistance);
+    bool empty() const { return values.empty(); }
+
+    // Interpolated signed distance, with its gradient (zero far from the obstacles)
+    float getDistance(const sim::Vector2f& point) const;
+    float getDistance(const sim::Vector2f& point, sim::Vector2f& gradient) const;
+
+    // Lower bound of the distance to the nearest obstacle
+    float getClearance(const sim::Vector2f& point) const { return getDistance(point) - nodeDiagonal; }
+
+    float getResolution() const { return resolution; }
+    float getMaxDistance() const { return maxDistance; }
+
+private:
+    sim::Vector2f origin;  // Position of the first node
+    float resolution = 1.0f;
+    float maxDistance = 0.0f;
+    float nodeDiagonal = 0.0f;
+    int columns = 0;       // Nodes per row
+    int rows = 0;
+    std::vector<float> values; // Row-major node distances
+};
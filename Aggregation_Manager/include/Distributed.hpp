@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+/*
+
+Distributed simulation over sockets
+
+The simulation area is split into vertical strips, one per rank (process). Every
+rank simulates the agents in its strip; after each frame it sends the agents that
+crossed into a neighbouring strip (migrants) and copies of the agents within the
+halo width of the strip edge (ghosts) to the left and right neighbour, and receives
+theirs. A coordinator process joins all ranks in a barrier at the end of every frame,
+sums their statistics and stops all ranks if one of them fails.
+
+distributed:
+  ranks: 4
+  coordinator: unix:/tmp/simulator_coordinator.sock  # or tcp:host:port
+  peers: [unix:/tmp/simulator_rank0.sock, ...]        # listening endpoint per rank (default: /tmp/simulator_rank<r>.sock)
+  halo: 20                                            # meters (default: collision cell size)
+
+SimulatorHeadless --coordinator config.yaml
+SimulatorHeadless --rank 0 config.yaml   (one process per rank)
+
+*/
+
+namespace Distributed {
+
+// Message types of the rank and coordinator connections
+enum MessageType : uint32_t {
+    Hello = 1,  // Rank of the sender
+    Agents,     // Migrants and ghosts for the receiving neighbour
+    FrameDone,  // FrameStats of a rank at the frame barrier
+    Continue,   // All ranks reached the barrier
+    Stop,       // A rank failed or stopped early
+    Finished    // FrameStats of a rank after its last frame
+};
+
+// Statistics a rank reports at every barrier
+struct FrameStats {
+    uint64_t frame = 0;
+    uint64_t agents = 0;
+    uint64_t arrivals = 0;
+    uint64_t departures = 0;
+    uint64_t ghosts = 0;
+};
+
+// Endpoints and halo of a distributed run
+struct Settings {
+    int ranks = 1;
+    std::string coordinator = "unix:/tmp/simulator_coordinator.sock";
+    std::vector<std::string> peers;
+    float halo = 0.0f;
+    int statsFrames = 100; // Frames between the coordinator's statistics
+
+    static Settings load(const YAML::Node& config);
+};
+
+} // namespace Distributed
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "Agent.hpp"
+#include "Distributed.hpp"
+#include "Socket.hpp"
+
+/*
+
+Strip of the simulation area owned by one rank of a distributed run
+
+The partition connects to the coordinator and to the ranks of the adjacent strips
+(rank r listens for r - 1 and connects to r + 1). Agents are serialized in the
+checkpoint format. Each neighbour's message is sent on a helper thread while the
+other messages are received, so that ranks never wait on each other's sends.
+
+*/
+
+class DistributedPartition {
+public:
+    // Connect to the coordinator and the neighbouring ranks (throws if a connection fails)
+    DistributedPartition(const Distributed::Settings& settings, int rank, float simulationWidth);
+
+    int getRank() const { return rank; }
+
+    // Whether a position lies in the strip (the outer strips extend beyond the area)
+    bool owns(const sim::Vector2f& position) const;
+
+    // Send migrants and halo agents, receive the neighbours' (throws if a neighbour fails)
+    // departures: ascending indices of the agents that moved to a neighbour
+    void exchange(const std::vector<Agent>& agents, std::vector<size_t>& departures, std::vector<Agent>& arrivals, std::vector<Agent>& ghosts);
+
+    // Frame barrier at the coordinator, false if the run is to stop
+    bool synchronize(uint64_t frame, size_t numAgents);
+
+    // Report the last frame to the coordinator
+    void finish(uint64_t frame, size_t numAgents);
+
+private:
+    struct Neighbour {
+        int rank;
+        bool left;                      // Strip to the left (smaller x)
+        Socket socket;
+        std::vector<size_t> migrants;   // Own agents to hand over
+        std::vector<size_t> halo;       // Own agents to copy
+        std::string outgoing;
+        bool sent = false;
+    };
+
+    void receive(Neighbour& neighbour, std::vector<Agent>& arrivals, std::vector<Agent>& ghosts, size_t& numGhosts);
+
+    int rank;
+    int ranks;
+    float stripBegin;  // Meters
+    float stripEnd;
+    float halo;
+
+    Socket coordinator;
+    std::vector<Neighbour> neighbours;
+    Distributed::FrameStats stats;
+    bool stopped = false;
+};
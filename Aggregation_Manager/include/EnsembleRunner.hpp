@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+#include "ScenarioData.hpp"
+
+/*
+
+Ensemble runner for parameter sweeps
+
+A sweep specification names a base configuration and the parameters to vary, each a
+dotted configuration path with a list of values. The runs are the cartesian product
+of the values, each repeated with consecutive seeds. They execute concurrently in
+one process on worker threads pinned to cores: a worker builds the simulation of its
+next run, runs it to completion without a renderer and moves on. Every run writes
+to its own namespace (database names and output files get a _run<index> suffix), and
+runs with the same taxonomies and obstacles share one parsed ScenarioData.
+
+ensemble:
+  base_config: config.yaml
+  threads: 64          # Worker threads (default: hardware concurrency)
+  pin_threads: true
+  repetitions: 4       # Seeds base seed, base seed + 1, ...
+  parameters:
+    agents.num_agents: [1000, 5000, 10000]
+    simulation.scenario: [default, continuous]
+
+*/
+
+class EnsembleRunner {
+public:
+    EnsembleRunner(const YAML::Node& sweep);
+
+    // Execute all runs, returns the number of failed runs
+    int run();
+
+    size_t getNumRuns() const { return runs.size(); }
+
+private:
+    struct Run {
+        std::string name;        // Namespace suffix, e.g. run007
+        std::string description; // Parameter values, for the log
+        YAML::Node config;       // Base configuration with the run's values (own copy)
+        std::shared_ptr<const ScenarioData> scenarioData;
+    };
+
+    void loadSweep(const YAML::Node& sweep);
+    void buildRuns();
+    void runWorker(int worker);
+    std::shared_ptr<const ScenarioData> getScenarioData(const YAML::Node& config);
+
+    static void setValue(YAML::Node root, const std::string& path, const YAML::Node& value);
+    static std::string addSuffix(const std::string& name, const std::string& suffix);
+    static void pinThread(int core);
+
+    // Sweep specification
+    YAML::Node baseConfig;
+    std::vector<std::pair<std::string, std::vector<YAML::Node>>> parameters;
+    int repetitions = 1;
+    int numWorkers = 1;
+    bool pinThreads = true;
+
+    // Runs, claimed by the workers in order
+    std::vector<Run> runs;
+    std::atomic<size_t> nextRun{0};
+    std::atomic<int> failedRuns{0};
+
+    // Parsed scenario data by serialized taxonomies and obstacles
+    std::unordered_map<std::string, std::shared_ptr<const ScenarioData>> scenarioCache;
+};
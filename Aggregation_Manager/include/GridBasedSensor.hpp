@@ -14,12 +14,12 @@ public:
     } GridDataPoint;
 
     // Every grid data stored with the cell id as key
-    typedef std::unordered_map<sf::Vector2i, GridDataPoint, Vector2iHash> GridData;
+    typedef std::unordered_map<sim::Vector2i, GridDataPoint, Vector2iHash> GridData;
 
     // Base constructor for simulation
     GridBasedSensor(
         float frameRate, 
-        sf::FloatRect detectionArea, 
+        sim::FloatRect detectionArea, 
         float cellSize, 
         const std::string& databaseName, 
         const std::string& collectionName, 
@@ -29,8 +29,8 @@ public:
 
     // Alternative constructor for rendering
     GridBasedSensor(
-        sf::FloatRect detectionArea, 
-        sf::Color detectionAreaColor, 
+        sim::FloatRect detectionArea, 
+        sim::Color detectionAreaColor, 
         float cellSize, 
         bool showGrid,
         SharedBuffer<sensorBufferFrameType>& sensorBuffer
@@ -41,10 +41,10 @@ public:
     bool showGrid = false;
     Grid currentGrid;
     Grid previousGrid;
-    sf::Vector2f position = sf::Vector2f(detectionArea.position.x, detectionArea.position.y);
+    sim::Vector2f position = sim::Vector2f(detectionArea.position.x, detectionArea.position.y);
 
-    // void update(std::vector<Agent>& agents, float timeStep, sf::Time simulationTime, std::string date) override;
-    void update(std::vector<Agent>& agents, float timeStep, std::chrono::system_clock::time_point timestamp) override;
+    // void update(std::vector<Agent>& agents, float timeStep, sim::Time simulationTime, std::string date) override;
+    void update(std::vector<Agent>& agents, const SimulationClock& clock) override;
     void postData() override;
     void postMetadata() override;
     void printData() override;
@@ -58,6 +58,6 @@ private:
     SharedBuffer<sensorBufferFrameType>& sensorBuffer;
     std::vector<std::pair<std::chrono::system_clock::time_point, GridData>> dataStorage;
     
-    sf::Vector2i getCellIndex(const sf::Vector2f& position) const;
-    sf::Vector2f getCellPosition(const sf::Vector2i& cellIndex) const;
+    sim::Vector2i getCellIndex(const sim::Vector2f& position) const;
+    sim::Vector2f getCellPosition(const sim::Vector2i& cellIndex) const;
 };
\ No newline at end of file
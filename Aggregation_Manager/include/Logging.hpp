@@ -1,5 +1,7 @@
 #pragma once
 
+#include <iostream> // For std::cout in the message macros
+
 #ifdef DEBUG
 #define DEBUG_MSG(str) do { std::cout << str << std::endl; } while( false )
 #else
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+
+Morton (Z-order) code helpers for the quadtree cell ids
+
+A cell id is a "11" sentinel followed by one (row, col) bit pair per depth level,
+e.g. base cells are 0b1100 - 0b1111. With the sentinel stripped, the column (x)
+bits sit on the even positions and the row (y) bits on the odd positions, so
+neighbours can be found with dilated-integer arithmetic instead of tree walks.
+
+*/
+
+namespace Morton { // Namespace to avoid name clashes
+
+constexpr uint32_t xMask = 0x55555555u; // Even bits (columns)
+constexpr uint32_t yMask = 0xAAAAAAAAu; // Odd bits (rows)
+
+// Depth of a cell id (base cells are depth 1, the "11" root is depth 0)
+inline int depth(uint32_t id) {
+    return id ? (31 - __builtin_clz(id)) / 2 : -1;
+}
+
+// Mask covering the 2 * depth code bits below the sentinel
+inline uint32_t levelMask(int depth) {
+    return (1u << (2 * depth)) - 1u;
+}
+
+// Remove the sentinel from a cell id
+inline uint32_t strip(uint32_t id, int depth) {
+    return id & levelMask(depth);
+}
+
+// Prepend the sentinel to a raw Morton code
+inline uint32_t attach(uint32_t code, int depth) {
+    return (0b11u << (2 * depth)) | code;
+}
+
+// Spread the lower 16 bits of v to the even bit positions
+inline uint32_t dilate(uint32_t v) {
+    v &= 0x0000FFFFu;
+    v = (v | (v << 8)) & 0x00FF00FFu;
+    v = (v | (v << 4)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+}
+
+// Gather the even bit positions of v into the lower 16 bits
+inline uint32_t compact(uint32_t v) {
+    v &= 0x55555555u;
+    v = (v | (v >> 1)) & 0x33333333u;
+    v = (v | (v >> 2)) & 0x0F0F0F0Fu;
+    v = (v | (v >> 4)) & 0x00FF00FFu;
+    v = (v | (v >> 8)) & 0x0000FFFFu;
+    return v;
+}
+
+// Interleave column and row into a raw Morton code
+inline uint32_t encode(uint32_t col, uint32_t row) {
+    return dilate(col) | (dilate(row) << 1);
+}
+
+inline uint32_t decodeCol(uint32_t code) { return compact(code); }
+inline uint32_t decodeRow(uint32_t code) { return compact(code >> 1); }
+
+// Dilated-integer addition and subtraction of two raw Morton codes
+inline uint32_t add(uint32_t a, uint32_t b) {
+    return (((a | yMask) + (b & xMask)) & xMask) | (((a | xMask) + (b & yMask)) & yMask);
+}
+
+inline uint32_t sub(uint32_t a, uint32_t b) {
+    return (((a & xMask) - (b & xMask)) & xMask) | (((a & yMask) - (b & yMask)) & yMask);
+}
+
+// Same-depth neighbour of a cell id in direction (dx, dy) with dx, dy in {-1, 0, 1}.
+// Returns -1 if the neighbour would lie outside the grid.
+inline int neighbor(uint32_t id, int dx, int dy) {
+    int d = depth(id);
+    if (d < 1) return -1;
+
+    uint32_t mask = levelMask(d);
+    uint32_t code = strip(id, d);
+    uint32_t colBits = code & xMask;
+    uint32_t rowBits = code & yMask;
+
+    // Reject steps across the grid border
+    if ((dx > 0 && colBits == (xMask & mask)) || (dx < 0 && colBits == 0u)) return -1;
+    if ((dy > 0 && rowBits == (yMask & mask)) || (dy < 0 && rowBits == 0u)) return -1;
+
+    // Step by one dilated unit along each axis (x unit = 0b01, y unit = 0b10)
+    if (dx > 0) code = add(code, 0b01u);
+    else if (dx < 0) code = sub(code, 0b01u);
+    if (dy > 0) code = add(code, 0b10u);
+    else if (dy < 0) code = sub(code, 0b10u);
+
+    return static_cast<int>(attach(code & mask, d));
+}
+
+// Ancestor of a cell id at a coarser depth
+inline uint32_t ancestor(uint32_t id, int fromDepth, int toDepth) {
+    return id >> (2 * (fromDepth - toDepth));
+}
+
+} // namespace Morton
@@ -1,22 +1,31 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
+#include <vector>
 
+#include "SimTypes.hpp"
 #include "Logging.hpp"
 
 /*************************************/
 /********** OBSTACLES CLASS **********/
 /*************************************/
 
-// Obstacle class
+// Obstacle class: a rectangle, or a simple polygon (e.g. a building footprint) enclosed by its bounds
 class Obstacle {
 public:
-    Obstacle(sf::FloatRect bounds, sf::Color color = sf::Color::Black);
+    Obstacle(sim::FloatRect bounds, sim::Color color = sim::Color::Black);
+    Obstacle(std::vector<sim::Vector2f> vertices, sim::Color color = sim::Color::Black);
 
-    sf::FloatRect getBounds() const { return bounds; }
-    sf::Color getColor() const { return color; }
+    sim::FloatRect getBounds() const { return bounds; }
+    sim::Color getColor() const { return color; }
+    const std::vector<sim::Vector2f>& getVertices() const { return vertices; } // Empty for rectangles
+    bool isPolygon() const { return !vertices.empty(); }
+
+    // Signed distance of a point to the outline, negative inside
+    float getSignedDistance(const sim::Vector2f& point) const;
+    bool contains(const sim::Vector2f& point) const;
 
 private:
-    sf::FloatRect bounds;
-    sf::Color color;
-};
\ No newline at end of file
+    sim::FloatRect bounds;
+    sim::Color color;
+    std::vector<sim::Vector2f> vertices;
+};
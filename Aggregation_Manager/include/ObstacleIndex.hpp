@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "Obstacle.hpp"
+
+/*
+
+Static spatial index of the obstacles
+
+The obstacles are bucketed once into a uniform grid over their bounding box, stored
+as one obstacle id list per cell (offsets into a single array). A query only tests the
+obstacles of the cells its area overlaps, so its cost does not grow with the number of
+obstacles in the scenario.
+
+The main query sweeps a circle (an agent's buffer zone) along a segment (its path
+within the look-ahead time) and returns the fraction of the segment at the first
+contact with an obstacle. The test is exact: the segment is intersected with the
+rectangle grown by the radius with rounded corners, or for polygons with a capsule
+around every edge. Sweeps are batched per frame.
+
+*/
+
+// Circles swept along segments and the fraction of each segment at the first obstacle contact
+struct SweptCircleBatch {
+    std::vector<size_t> ids; // Caller's id of each sweep (e.g. an agent index)
+    std::vector<sim::Vector2f> start;
+    std::vector<sim::Vector2f> end;
+    std::vector<float> radius;
+    std::vector<float> hit; // Infinity if the sweep is free
+
+    void clear() { ids.clear(); start.clear(); end.clear(); radius.clear(); hit.clear(); }
+    void add(size_t id, const sim::Vector2f& from, const sim::Vector2f& to, float circleRadius) {
+        ids.push_back(id);
+        start.push_back(from);
+        end.push_back(to);
+        radius.push_back(circleRadius);
+    }
+};
+
+class ObstacleIndex {
+public:
+    static constexpr float noHit = std::numeric_limits<float>::infinity();
+
+    // Bucket the obstacles, a cell size of 0 is derived from the obstacle density
+    void build(const std::vector<Obstacle>& obstacles, float cellSize = 0.0f);
+    bool empty() const { return rects.empty(); }
+
+    // Fraction of the segment at the first contact of the swept circle, noHit if free
+    float sweep(const sim::Vector2f& start, const sim::Vector2f& end, float radius) const;
+    void sweep(SweptCircleBatch& batch) const;
+
+    // Whether a circle overlaps an obstacle
+    bool overlaps(const sim::Vector2f& center, float radius) const { return sweep(center, center, radius) != noHit; }
+
+private:
+    std::vector<sim::FloatRect> rects; // Obstacle bounds with positive sizes
+    std::unordered_map<uint32_t, Obstacle> polygons; // Polygon obstacles by id, tested exactly once their bounds are hit
+    sim::Vector2f origin;
+    float cellSize = 1.0f;
+    int columns = 0;
+    int rows = 0;
+    std::vector<uint32_t> cellStart;     // Offsets into cellObstacles per cell, one past the end last
+    std::vector<uint32_t> cellObstacles; // Obstacle ids of all cells
+};
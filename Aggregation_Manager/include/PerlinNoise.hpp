@@ -1,18 +1,46 @@
 #pragma once
 
-#include <random>
-#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
 
 #include "Logging.hpp"
 
+/*
+
+Seeded gradient noise (Perlin or simplex) with one shared permutation table
+
+A single generator is shared by all agents; agents decorrelate by offsetting their
+coordinates. The batched evaluator works on structure-of-arrays inputs in float
+precision and evaluates four points at a time with SSE2 intrinsics: floors, fades,
+corner ranks and gradient selection run on all lanes without branches, only the
+permutation lookups are scalar loads. The remainder (and builds without SSE2) use the
+scalar loop, which gives the same values. Values are in [0, 1].
+
+*/
+
 class PerlinNoise {
 public:
-    PerlinNoise(unsigned int seed = std::default_random_engine::default_seed); // Constructor
-    double noise(double x, double y, double z);
+    enum class Type { Perlin, Simplex };
+
+    PerlinNoise(uint64_t seed = 0, Type type = Type::Perlin); // Constructor
+
+    // Noise at a single point
+    float noise(float x, float y, float z) const;
+
+    // Noise at count points given as separate coordinate arrays
+    void noise(const float* x, const float* y, const float* z, float* out, size_t count) const;
+
+    // Parse "perlin" or "simplex" (defaults to Perlin)
+    static Type parseType(const std::string& name);
+
+    Type getType() const { return type; }
 
 private:
-    std::vector<int> p;
-    double fade(double t);
-    double lerp(double t, double a, double b);
-    double grad(int hash, double x, double y, double z);
-};
\ No newline at end of file
+    void perlinBatch(const float* x, const float* y, const float* z, float* out, size_t count) const;
+    void simplexBatch(const float* x, const float* y, const float* z, float* out, size_t count) const;
+
+    Type type;
+    std::array<int32_t, 512> p; // Permutation of 0 to 255, duplicated
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "Logging.hpp"
+
+/*
+
+Online k-anonymity, l-diversity and delta-presence metrics
+
+Every sensor observation is put into an equivalence class of (time bin, speed bin,
+position bin), the same quasi-identifiers as Data_analysis/spatial_temporal_aggregation.py.
+Per class the observation count (k), a bit set of the agent types (l) and the hashed
+agent ids are kept. delta-presence is the share of the distinct agents of the time bin
+that are in the class. When the time bin is over, one row per class is appended to
+the CSV in the format of privacy_metrics.csv.
+
+*/
+
+class PrivacyMetrics {
+public:
+    PrivacyMetrics(float speedBinSize, float positionBinSize, float timeWindow, const std::string& outputPath);
+    ~PrivacyMetrics();
+
+    // Add one observation (positions in meters, velocities in m/s)
+    void addObservation(
+        std::chrono::system_clock::time_point timestamp,
+        const std::string& agentId,
+        const std::string& agentType,
+        sim::Vector2f position,
+        sim::Vector2f velocity
+    );
+
+    // Write the rows of the current time bin
+    void flush();
+
+    float speedBinSize;
+    float positionBinSize;
+    float timeWindow; // Seconds
+
+private:
+    // Counts of one equivalence class
+    struct ClassStats {
+        int count = 0;                             // k-anonymity
+        uint64_t agentTypeMask = 0;                // One bit per agent type, l-diversity
+        std::unordered_set<uint64_t> agentHashes;  // Distinct agents, for delta-presence
+    };
+
+    // Speed bin (16 bit) and x, y position bins (24 bit each) packed into one key
+    static uint64_t makeKey(int speedBin, int positionBinX, int positionBinY);
+    static int getSpeedBin(uint64_t key);
+    static int getPositionBinX(uint64_t key);
+    static int getPositionBinY(uint64_t key);
+
+    uint64_t getAgentTypeBit(const std::string& agentType);
+    void writeRows();
+
+    std::ofstream output;
+    int64_t currentTimeBin = -1;
+    std::chrono::system_clock::time_point currentTimeBinStart;
+    std::unordered_map<uint64_t, ClassStats> classes;   // Classes of the current time bin
+    std::unordered_set<uint64_t> timeBinAgentHashes;    // Distinct agents of the current time bin
+    std::unordered_map<std::string, int> agentTypeBits;
+};
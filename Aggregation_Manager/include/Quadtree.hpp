@@ -1,6 +1,5 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
@@ -8,15 +7,26 @@
 #include <stdexcept>
 #include <cmath>
 #include <random>
+#include "SimTypes.hpp"
 #include "Agent.hpp"
+#include "Morton.hpp"
+
+// Drawing is defined in QuadtreeDraw.cpp, part of the GUI executable only
+namespace sf {
+class RenderWindow;
+class Font;
+}
 
 // The Quadtree class encapsulates the data‐structure logic.
-// Nodes store their geometry in an sf::FloatRect (left, top, width, height).
+// Nodes store their geometry in a sim::FloatRect (left, top, width, height).
 class Quadtree {
 public:
+    // Neighbourhoods supported by the Morton-code neighbour lookup
+    enum class Neighborhood { Four = 4, Eight = 8 };
+
     // A Node stores its bounds, pointers to its children, its unique id, and depth.
     struct Node {
-        sf::FloatRect bounds; // Defines the cell's position and size.
+        sim::FloatRect bounds; // Defines the cell's position and size.
         bool isSplit;
         Node* parent;
         Node* children[4];
@@ -31,17 +41,17 @@ public:
         // Splits the node into 4 children and registers them in nodeMap.
         void split(std::unordered_map<int, Node*>& nodeMap);
         void draw(sf::RenderWindow& window, sf::Font& font);
-        void draw(sf::RenderWindow& window, sf::Font& font, float scale, const sf::Vector2f& offset);
-        void draw(sf::RenderWindow& window, sf::Font& font, float scale, const sf::Vector2f& offset, bool showCellId);
+        void draw(sf::RenderWindow& window, sf::Font& font, float scale, const sim::Vector2f& offset);
+        void draw(sf::RenderWindow& window, sf::Font& font, float scale, const sim::Vector2f& offset, bool showCellId);
     };
 
     // Data members
     float cellSize;
-    sf::Vector2f origin;
+    sim::Vector2f origin;
     int maxDepth;
     std::vector<Node*> baseNodes;               // The four base cells.
     std::unordered_map<int, Node*> nodeMap;     // Maps cell IDs to nodes.
-    std::vector<sf::Vector2f> positions;        // Agent positions (or any positions)
+    std::vector<sim::Vector2f> positions;        // Agent positions (or any positions)
     std::vector<Agent*> agents;                 // Agents in the quadtree
     bool showCellId = false;
 
@@ -78,28 +88,38 @@ public:
     }
 
     // Returns the center of the cell given its id.
-    sf::Vector2f getCellCenter(int id) const;
+    sim::Vector2f getCellCenter(int id) const;
 
     // Returns the positon of the cell (top-left corner) given its id.
-    sf::Vector2f getCellPosition(int id) const;
+    sim::Vector2f getCellPosition(int id) const;
+
+    // Returns the bounds of any cell id, whether or not it is currently split into existence.
+    sim::FloatRect getCellBounds(int id) const;
 
     // Returns the dimensions of the cell given its id. // Not yet implemented.
-    sf::Vector2f getCellDimensions(int id) const;
+    sim::Vector2f getCellDimensions(int id) const;
+
+    // Returns the same-depth id next to a cell in direction (dx, dy), or -1 outside the grid.
+    int getNeighborId(int id, int dx, int dy) const;
 
-    // Returns the IDs of neighboring cells (at the same depth or leaves).
-    std::vector<int> getNeighboringCells(int id);
+    // Returns the existing cell (same depth or coarser) next to a cell in direction (dx, dy), or -1.
+    int getNeighborCell(int id, int dx, int dy) const;
+
+    // Returns the IDs of neighboring cells (at the same depth or coarser leaves).
+    std::vector<int> getNeighboringCells(int id, Neighborhood neighborhood = Neighborhood::Eight) const;
+    void getNeighboringCells(int id, Neighborhood neighborhood, std::vector<int>& neighbors) const;
 
     // Given a position, returns the smallest cell (leaf) that contains it.
-    int getNearestCell(sf::Vector2f position);
+    int getNearestCell(sim::Vector2f position);
 
     // Computes a cell id for a given position (using the maxDepth).
-    int makeCell(sf::Vector2f position);
+    int makeCell(sim::Vector2f position);
 
     // Compute the split sequence (list of child indexes) for a cell id.
     std::vector<int> getSplitSequence(int cellID);
 
     // Compute split sequences for a set of positions.
-    std::vector<std::vector<int>> getSplitSequences(const std::vector<sf::Vector2f>& positions);
+    std::vector<std::vector<int>> getSplitSequences(const std::vector<sim::Vector2f>& positions);
     
     // Split the quadtree according to the current positions.
     void splitFromPositions();
@@ -115,24 +135,25 @@ public:
     // Draw the quadtree structure and the positions.
     void draw(sf::RenderWindow& window, sf::Font& font);  // MOVE TO RENDERER
 
-    void draw(sf::RenderWindow& window, sf::Font& font, float scale, const sf::Vector2f& offset);
+    void draw(sf::RenderWindow& window, sf::Font& font, float scale, const sim::Vector2f& offset);
 
     // Draw the positions as red circles.
-    void drawPositions(sf::RenderWindow& window, const std::vector<sf::Vector2f>& positions);  // DELETE
+    void drawPositions(sf::RenderWindow& window, const std::vector<sim::Vector2f>& positions);  // DELETE
 
     int addAgent(Agent* agent);
 
     // Debug: prints the children of a node.
     void printChildren(int id);
 
-    // Custom hash function for sf::Vector2f so it can be used in unordered_map.
+    // Custom hash function for sim::Vector2f so it can be used in unordered_map.
     struct Vector2fHash {
-        std::size_t operator()(const sf::Vector2f& v) const;
+        std::size_t operator()(const sim::Vector2f& v) const;
     };
 
-private:
     // Returns the depth of a cell based on the number of bits in its id.
     int getDepth(int id) const;
+
+private:
     // Helper functions for Morton-code encoding/decoding.
     int mortonEncode(int row, int col) const;
     std::pair<int, int> mortonDecode(int id) const;
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+/*
+
+Counter-based random streams (Philox4x32-10)
+
+A Philox generator is a keyed bijection of a 128-bit counter: the key is the
+simulation seed and the upper half of the counter is a stream id, e.g. an agent
+index. Every (seed, stream) pair gives an independent sequence that does not depend
+on which thread draws it or in which order, so initialization can run in parallel
+and still reproduce the same population for a seed. Conversions to floats, normals
+and ranges are done here instead of with the std distributions, whose algorithms
+differ between standard libraries.
+
+*/
+
+// Stream id namespaces, combined with an index by RandomStream::id
+namespace RandomStream {
+
+constexpr uint32_t Agents = 1;     // Indexed by agent number at initialization
+constexpr uint32_t Spawning = 2;   // Continuous scenario arrivals
+constexpr uint32_t Noise = 3;      // Permutation table of the velocity noise
+constexpr uint32_t Ids = 4;        // Agent UUIDs, indexed like Agents
+
+inline uint64_t id(uint32_t space, uint32_t index) {
+    return (static_cast<uint64_t>(space) << 32) | index;
+}
+
+} // namespace RandomStream
+
+class Philox4x32 {
+public:
+    using result_type = uint32_t;
+
+    Philox4x32(uint64_t seed = 0, uint64_t stream = 0) {
+        key[0] = static_cast<uint32_t>(seed);
+        key[1] = static_cast<uint32_t>(seed >> 32);
+        counter[2] = static_cast<uint32_t>(stream);
+        counter[3] = static_cast<uint32_t>(stream >> 32);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    // Next 32 random bits (one block yields four outputs)
+    result_type operator()() {
+        if (position == 4) {
+            generateBlock();
+        }
+        return output[position++];
+    }
+
+    // Uniform float in [0, 1) from the upper 24 bits
+    float uniform() {
+        return static_cast<float>((*this)() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Uniform float in [a, b)
+    float uniform(float a, float b) {
+        return a + (b - a) * uniform();
+    }
+
+    // Uniform integer in [0, n) (multiply-shift, negligible bias for small n)
+    uint32_t uniformIndex(uint32_t n) {
+        return static_cast<uint32_t>((static_cast<uint64_t>((*this)()) * n) >> 32);
+    }
+
+    // Normal distribution (Box-Muller, one value per call)
+    float normal(float mean, float stddev) {
+        float u1 = 1.0f - uniform(); // (0, 1]
+        float u2 = uniform();
+        return mean + stddev * std::sqrt(-2.0f * std::log(u1)) * std::cos(6.28318530718f * u2);
+    }
+
+    // Exponential distribution with a rate
+    float exponential(float rate) {
+        return -std::log(1.0f - uniform()) / rate;
+    }
+
+private:
+    static void multiplyHighLow(uint32_t a, uint32_t b, uint32_t& high, uint32_t& low) {
+        uint64_t product = static_cast<uint64_t>(a) * b;
+        high = static_cast<uint32_t>(product >> 32);
+        low = static_cast<uint32_t>(product);
+    }
+
+    // Encrypt the counter with 10 rounds, then increment its lower 64 bits
+    void generateBlock() {
+        uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+        uint32_t k[2] = {key[0], key[1]};
+
+        for (int round = 0; round < 10; ++round) {
+            uint32_t high0, low0, high1, low1;
+            multiplyHighLow(0xD2511F53u, c[0], high0, low0);
+            multiplyHighLow(0xCD9E8D57u, c[2], high1, low1);
+            c[0] = high1 ^ c[1] ^ k[0];
+            c[1] = low1;
+            c[2] = high0 ^ c[3] ^ k[1];
+            c[3] = low0;
+            k[0] += 0x9E3779B9u;
+            k[1] += 0xBB67AE85u;
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            output[i] = c[i];
+        }
+        position = 0;
+
+        if (++counter[0] == 0) {
+            ++counter[1];
+        }
+    }
+
+    uint32_t key[2];
+    uint32_t counter[4] = {0, 0, 0, 0};
+    uint32_t output[4] = {0, 0, 0, 0};
+    int position = 4;
+};
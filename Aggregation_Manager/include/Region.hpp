@@ -1,11 +1,11 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <cmath>
 
+#include "SimTypes.hpp"
 #include "Logging.hpp"
 #include "Utilities.hpp"
 
@@ -41,6 +41,6 @@ public:
 
     RegionTypeAttributes attributes;
     std::string type;
-    sf::FloatRect area;
-    sf::Color colorAlpha;  // sf::Color colorAlpha = sf::Color(color.r, color.g, color.b, alpha * 255);
+    sim::FloatRect area;
+    sim::Color colorAlpha;  // sim::Color colorAlpha = sim::Color(color.r, color.g, color.b, alpha * 255);
 };
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "Region.hpp"
+#include "Quadtree.hpp"
+#include "Morton.hpp"
+#include "Logging.hpp"
+
+/*
+
+Region lookup index
+
+The simulation area is rasterized once into a grid of region set ids, where a region
+set is the (deduplicated) list of indices of the regions covering a raster cell and
+set 0 means no region. Points are looked up in O(1). For a quadtree, a table indexed
+by the Morton cell id stores the region set each node overlaps and whether the node is
+mixed (not covered by one set throughout), built bottom-up from the leaves.
+
+*/
+
+class RegionIndex {
+public:
+
+    // Regions overlapping an area
+    struct Cover {
+        int regionSet = 0;  // Union of all region sets in the area
+        bool mixed = false; // True if the area is not covered by the same regions throughout
+    };
+
+    // Covers of all quadtree nodes indexed by cell id
+    class CellTable {
+    public:
+        // Cover of a cell, cells below the table depth use their ancestor's cover
+        Cover getCover(int cellId) const;
+        bool empty() const { return covers.empty(); }
+
+    private:
+        friend class RegionIndex;
+        int tableDepth = 0;
+        std::vector<Cover> covers; // Index: cell id (sentinel included)
+    };
+
+    void build(const std::vector<Region>& regions, sim::Vector2f size, float resolution);
+
+    // Region set at a position (O(1))
+    int getRegionSet(sim::Vector2f position) const;
+
+    // Region set and mixed flag of all raster cells overlapping an area
+    Cover getCover(const sim::FloatRect& area);
+
+    // Morton-indexed covers of a quadtree down to min(maxDepth, maxTableDepth)
+    CellTable buildCellTable(const Quadtree& quadtree);
+
+    const std::vector<int>& getRegions(int regionSet) const { return regionSets[regionSet]; }
+    size_t getNumRegionSets() const { return regionSets.size(); }
+
+    static constexpr int maxTableDepth = 8; // 4^9 entries at most
+
+private:
+    int addToRegionSet(int regionSet, int regionIndex);
+    int mergeRegionSets(int regionSetA, int regionSetB);
+    int getRegionSetId(const std::vector<int>& regionList);
+
+    float resolution = 1.0f;
+    int columns = 0;
+    int rows = 0;
+    std::vector<int> raster; // Region set per raster cell, row-major
+
+    std::vector<std::vector<int>> regionSets{{}}; // Sorted region indices per set, set 0 is empty
+    std::map<std::vector<int>, int> regionSetIds;
+    std::map<std::pair<int, int>, int> mergedRegionSets; // Memoized unions
+};
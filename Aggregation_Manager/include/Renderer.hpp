@@ -60,7 +60,6 @@ private:
         sf::Vector2f velocity;
         sf::Vector2f heading;
         float velocityMagnitude;
-        std::vector<sf::Vector2f> trajectory;
         float bodyRadius;
         float bufferZoneRadius;
         sf::Color color;
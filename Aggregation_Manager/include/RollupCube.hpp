@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Logging.hpp"
+
+/*
+
+Hierarchical roll-up of adaptive grid counts over quadtree cells and time
+
+Every count added for a cell is also added to all of its ancestors (cell id >> 2 up to
+the "11" root), so each node holds the summed counts of its subtree. Per node and agent
+type a series of temporal prefix sums is kept, so the counts of any node over any time
+range are two binary searches away instead of a scan over the leaf documents. Nodes
+finer than the cells the sensor reported hold no counts.
+
+*/
+
+class RollupCube {
+public:
+    // Add the counts of one cell for one sensor frame to the cell and all its ancestors
+    void add(int cellId, std::chrono::system_clock::time_point timestamp, const std::unordered_map<std::string, int>& agentTypeCount, int totalAgents);
+
+    // Counts per agent type of a node within [start, end)
+    std::unordered_map<std::string, int64_t> query(int cellId, std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end) const;
+
+    // Total count of a node within [start, end)
+    int64_t queryTotal(int cellId, std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end) const;
+
+    // Binary (de)serialization, series are written in Morton order
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    void clear();
+
+private:
+    // Prefix sums over time of one node and agent type
+    struct Series {
+        std::vector<int64_t> times;      // Milliseconds since epoch, ascending
+        std::vector<int64_t> prefixSums; // Sum of all counts up to and including times[i]
+
+        void add(int64_t time, int64_t count);
+        int64_t sum(int64_t start, int64_t end) const;
+    };
+
+    static constexpr int totalIndex = 0xFF; // Type index of the total agents series
+    static constexpr uint32_t fileVersion = 1;
+
+    static uint64_t makeKey(int cellId, int typeIndex) { return (static_cast<uint64_t>(cellId) << 8) | static_cast<uint64_t>(typeIndex); }
+    static int64_t toMilliseconds(std::chrono::system_clock::time_point timestamp);
+    int getTypeIndex(const std::string& agentType);
+
+    std::unordered_map<uint64_t, Series> series; // Key: cell id, type index
+    std::vector<std::string> agentTypes;
+    std::unordered_map<std::string, int> agentTypeIndices;
+    std::vector<std::pair<int, int>> typeCounts; // Type index, count (reused between calls)
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+#include "Agent.hpp"
+#include "Region.hpp"
+#include "Obstacle.hpp"
+#include "ObstacleIndex.hpp"
+#include "DistanceField.hpp"
+
+/*
+
+Read-only scenario data parsed from the configuration
+
+The agent taxonomy, region taxonomy and obstacles do not change while a simulation
+runs. They are parsed once into an immutable object that simulations hold by shared
+pointer, so the runs of an ensemble with the same taxonomies and obstacles share one
+copy instead of parsing their own.
+
+*/
+
+class ScenarioData {
+public:
+
+    // Parse the taxonomies and obstacles of a configuration
+    static std::shared_ptr<const ScenarioData> load(const YAML::Node& config);
+
+    std::unordered_map<std::string, Agent::AgentTypeAttributes> agentTypeAttributes;
+    std::unordered_map<std::string, Region::RegionTypeAttributes> regionTypeAttributes;
+    std::vector<Obstacle> obstacles;
+    ObstacleIndex obstacleIndex; // Built once from the obstacles
+    DistanceField distanceField; // Empty unless configured
+
+private:
+    void loadAgentsAttributes(const YAML::Node& config);
+    void loadRegionsAttributes(const YAML::Node& config);
+    void loadObstacles(const YAML::Node& config);
+};
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
 #include <unordered_map>
 #include <vector>
 #include <chrono>
@@ -11,9 +10,14 @@
 #include <mongocxx/collection.hpp>
 #include <unordered_set>
 
+#include "SimTypes.hpp"
 #include "Agent.hpp"
 #include "Utilities.hpp"
 #include "SharedBuffer.hpp"
+#include "SimulationClock.hpp"
+
+class CheckpointWriter;
+class CheckpointReader;
 
 // using agentFrameType = const std::vector<Agent>; // only for renderer
 // using sensorFrameType = const std::unordered_map<std::string, std::unordered_set<int>>; // only for renderer
@@ -28,36 +32,43 @@ class Sensor {
 public:
     Sensor(
         float frameRate, 
-        sf::FloatRect detectionArea, 
+        sim::FloatRect detectionArea, 
         std::shared_ptr<mongocxx::client> client,
         SharedBuffer<sensorBufferFrameType>& sensorBuffer
     );
     Sensor(
-        const sf::FloatRect& detectionArea, 
-        const sf::Color& detectionAreaColor,
+        const sim::FloatRect& detectionArea, 
+        const sim::Color& detectionAreaColor,
         SharedBuffer<sensorBufferFrameType>& sensorBuffer
     );
-    // virtual void update(std::vector<Agent>& agents, float timeStep, sf::Time simulationTime, std::string datetime) = 0;
-    virtual void update(std::vector<Agent>& agents, float timeStep, std::chrono::system_clock::time_point timestamp) = 0;
+    // virtual void update(std::vector<Agent>& agents, float timeStep, sim::Time simulationTime, std::string datetime) = 0;
+    virtual void update(std::vector<Agent>& agents, const SimulationClock& clock) = 0;
     virtual void printData() = 0;
     virtual void postData() = 0;
     virtual void postMetadata() = 0;
     virtual void clearDatabase() = 0;
     virtual ~Sensor() = default;
 
-    sf::Color detectionAreaColor;
-    sf::FloatRect detectionArea;
+    // Checkpoint of the state carried between updates (last timestamp, positions for velocity estimates)
+    virtual void saveState(CheckpointWriter& writer) const;
+    virtual void loadState(CheckpointReader& reader);
+
+    sim::Color detectionAreaColor;
+    sim::FloatRect detectionArea;
     float frameRate;
     int scale;
     std::chrono::system_clock::time_point timestamp;
-    std::unordered_map<std::string, sf::Vector2f> previousPositions;
-    std::unordered_map<std::string, sf::Vector2f> currentPositions;
+    std::unordered_map<std::string, sim::Vector2f> previousPositions;
+    std::unordered_map<std::string, sim::Vector2f> currentPositions;
     std::string sensorId;
 
 protected:
     std::shared_ptr<mongocxx::client> client;
     SharedBuffer<sensorBufferFrameType>& sensorBuffer;
-    float timeSinceLastUpdate = 0.0f;
+    uint64_t updateInterval = 0; // Ticks between updates, from the frame rate
+
+    // True on exact multiples of the update interval
+    bool isUpdateDue(const SimulationClock& clock);
 
-    void estimateVelocities(std::unordered_map<std::string, sf::Vector2f>& estimatedVelocities);
+    void estimateVelocities(std::unordered_map<std::string, sim::Vector2f>& estimatedVelocities);
 };
\ No newline at end of file
@@ -33,6 +33,10 @@ public:
     T read();
     void swap();
     void end();
+
+    // Area shown by the reader in meters (level-of-detail updates), false if nothing is shown
+    void setViewport(const sim::FloatRect& area);
+    bool getViewport(sim::FloatRect& area);
     std::atomic<std::queue<T>*> currentReadBuffer;
     std::atomic<std::queue<T>*> currentWriteBuffer;
     std::atomic<int> writeBufferIndex;
@@ -40,6 +44,7 @@ public:
     std::atomic<size_t> currentReadFrameIndex;
     std::atomic<size_t> currentWriteFrameIndex;
     std::atomic<bool> stop = false;
+    bool discardFrames = false; // No reader (headless runs): count written frames without storing them
     std::string name;
 
 private:
@@ -48,6 +53,9 @@ private:
     std::condition_variable queueCond;
     T currentFrame;
     std::atomic<bool> finished = false;
+    std::mutex viewportMutex;
+    sim::FloatRect viewport;
+    bool hasViewport = false;
 };
 
 #include "SharedBuffer.tpp"
\ No newline at end of file
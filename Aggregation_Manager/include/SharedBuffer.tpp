@@ -18,6 +18,12 @@ SharedBuffer<T>::SharedBuffer(std::string name) :  writeBufferIndex(0), readBuff
 template <typename T>
 void SharedBuffer<T>::write(const T& frame) {
 
+    // Without a reader only the frame index advances
+    if (discardFrames) {
+        ++currentWriteFrameIndex;
+        return;
+    }
+
     // Lock the queue
     std::lock_guard<std::mutex> lock(queueMutex);
     DEBUG_MSG("Simulation: writing frame " << currentWriteFrameIndex << " to " << name << " buffer " << writeBufferIndex);
@@ -103,4 +109,21 @@ void SharedBuffer<T>::end() {
     std::lock_guard<std::mutex> lock(queueMutex); // New
     finished.store(true);
     queueCond.notify_one(); // New
-}
\ No newline at end of file
+}
+// Publish the area shown by the reader
+template <typename T>
+void SharedBuffer<T>::setViewport(const sim::FloatRect& area) {
+
+    std::lock_guard<std::mutex> lock(viewportMutex);
+    viewport = area;
+    hasViewport = true;
+}
+
+// Area shown by the reader, false if there is no reader showing the simulation
+template <typename T>
+bool SharedBuffer<T>::getViewport(sim::FloatRect& area) {
+
+    std::lock_guard<std::mutex> lock(viewportMutex);
+    area = viewport;
+    return hasViewport;
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/*
+
+Math and time types of the simulation core
+
+The core (simulation, agents, grids, sensors) uses these instead of the SFML types
+so that it builds without a windowing library. The interface follows SFML 3 (x/y
+vectors, rects with position and size, colors, microsecond times and a clock), so
+the code reads the same. Vectors, rects and colors convert implicitly to and from
+any type with the same members and constructor, e.g. sf::Vector2f, which is how the
+renderer passes values across.
+
+*/
+
+namespace sim {
+
+/*** Vectors ***/
+
+template <typename T>
+struct Vector2;
+
+template <typename V> struct IsVector2 : std::false_type {};
+template <typename T> struct IsVector2<Vector2<T>> : std::true_type {};
+
+// Another library's vector with x and y members of type T
+template <typename V, typename T, typename = void>
+struct IsForeignVector2 : std::false_type {};
+template <typename V, typename T>
+struct IsForeignVector2<V, T, std::enable_if_t<std::is_same_v<decltype(std::declval<V&>().x), T> &&
+                                               std::is_same_v<decltype(std::declval<V&>().y), T>>>
+    : std::bool_constant<!IsVector2<V>::value> {};
+
+template <typename T>
+struct Vector2 {
+    T x = T(0);
+    T y = T(0);
+
+    constexpr Vector2() = default;
+    constexpr Vector2(T x, T y) : x(x), y(y) {}
+
+    // Explicit conversion between component types
+    template <typename U>
+    constexpr explicit Vector2(const Vector2<U>& other) : x(static_cast<T>(other.x)), y(static_cast<T>(other.y)) {}
+
+    // From another library's vector with the same component type
+    template <typename V, typename = std::enable_if_t<IsForeignVector2<V, T>::value>>
+    constexpr Vector2(const V& other) : x(other.x), y(other.y) {}
+
+    // To another library's vector with the same component type
+    template <typename V, typename = std::enable_if_t<IsForeignVector2<V, T>::value>>
+    constexpr operator V() const { return V(x, y); }
+};
+
+template <typename T> constexpr Vector2<T> operator-(const Vector2<T>& a) { return {-a.x, -a.y}; }
+template <typename T> constexpr Vector2<T> operator+(const Vector2<T>& a, const Vector2<T>& b) { return {a.x + b.x, a.y + b.y}; }
+template <typename T> constexpr Vector2<T> operator-(const Vector2<T>& a, const Vector2<T>& b) { return {a.x - b.x, a.y - b.y}; }
+template <typename T> constexpr Vector2<T> operator*(const Vector2<T>& a, T s) { return {a.x * s, a.y * s}; }
+template <typename T> constexpr Vector2<T> operator*(T s, const Vector2<T>& a) { return {a.x * s, a.y * s}; }
+template <typename T> constexpr Vector2<T> operator/(const Vector2<T>& a, T s) { return {a.x / s, a.y / s}; }
+template <typename T> constexpr Vector2<T>& operator+=(Vector2<T>& a, const Vector2<T>& b) { a.x += b.x; a.y += b.y; return a; }
+template <typename T> constexpr Vector2<T>& operator-=(Vector2<T>& a, const Vector2<T>& b) { a.x -= b.x; a.y -= b.y; return a; }
+template <typename T> constexpr Vector2<T>& operator*=(Vector2<T>& a, T s) { a.x *= s; a.y *= s; return a; }
+template <typename T> constexpr Vector2<T>& operator/=(Vector2<T>& a, T s) { a.x /= s; a.y /= s; return a; }
+template <typename T> constexpr bool operator==(const Vector2<T>& a, const Vector2<T>& b) { return a.x == b.x && a.y == b.y; }
+template <typename T> constexpr bool operator!=(const Vector2<T>& a, const Vector2<T>& b) { return !(a == b); }
+
+using Vector2f = Vector2<float>;
+using Vector2i = Vector2<int>;
+using Vector2u = Vector2<unsigned int>;
+
+/*** Rectangles ***/
+
+template <typename T>
+struct Rect {
+    Vector2<T> position; // Top-left corner
+    Vector2<T> size;
+
+    constexpr Rect() = default;
+    constexpr Rect(const Vector2<T>& position, const Vector2<T>& size) : position(position), size(size) {}
+
+    // From any other rect type with position and size members
+    template <typename R, typename = decltype(std::declval<const R&>().position),
+              typename = decltype(std::declval<const R&>().size),
+              typename = std::enable_if_t<!std::is_same_v<R, Rect>>>
+    constexpr Rect(const R& other) : position(other.position), size(other.size) {}
+
+    // To any other rect type constructible from two vectors
+    template <typename R, typename = std::enable_if_t<!std::is_same_v<R, Rect> &&
+                                                      std::is_constructible_v<R, Vector2<T>, Vector2<T>>>>
+    constexpr operator R() const { return R(position, size); }
+
+    // Half-open containment, as in SFML
+    constexpr bool contains(const Vector2<T>& point) const {
+        T minX = std::min(position.x, static_cast<T>(position.x + size.x));
+        T maxX = std::max(position.x, static_cast<T>(position.x + size.x));
+        T minY = std::min(position.y, static_cast<T>(position.y + size.y));
+        T maxY = std::max(position.y, static_cast<T>(position.y + size.y));
+        return point.x >= minX && point.x < maxX && point.y >= minY && point.y < maxY;
+    }
+
+    // Overlapping area, empty if the rectangles do not overlap
+    std::optional<Rect> findIntersection(const Rect& other) const {
+        T left = std::max(std::min(position.x, static_cast<T>(position.x + size.x)),
+                          std::min(other.position.x, static_cast<T>(other.position.x + other.size.x)));
+        T top = std::max(std::min(position.y, static_cast<T>(position.y + size.y)),
+                         std::min(other.position.y, static_cast<T>(other.position.y + other.size.y)));
+        T right = std::min(std::max(position.x, static_cast<T>(position.x + size.x)),
+                           std::max(other.position.x, static_cast<T>(other.position.x + other.size.x)));
+        T bottom = std::min(std::max(position.y, static_cast<T>(position.y + size.y)),
+                            std::max(other.position.y, static_cast<T>(other.position.y + other.size.y)));
+
+        if (left < right && top < bottom) {
+            return Rect({left, top}, {right - left, bottom - top});
+        }
+        return std::nullopt;
+    }
+
+    // SFML 2 name of findIntersection
+    bool intersects(const Rect& other) const { return findIntersection(other).has_value(); }
+
+    constexpr Vector2<T> getCenter() const { return position + size / static_cast<T>(2); }
+};
+
+template <typename T> constexpr bool operator==(const Rect<T>& a, const Rect<T>& b) { return a.position == b.position && a.size == b.size; }
+template <typename T> constexpr bool operator!=(const Rect<T>& a, const Rect<T>& b) { return !(a == b); }
+
+using FloatRect = Rect<float>;
+using IntRect = Rect<int>;
+
+/*** Colors ***/
+
+struct Color {
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+    uint8_t a = 255;
+
+    constexpr Color() = default;
+    constexpr Color(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) : r(r), g(g), b(b), a(a) {}
+
+    // From any other color type with r, g, b and a members
+    template <typename C, typename = decltype(std::declval<const C&>().a),
+              typename = std::enable_if_t<!std::is_same_v<C, Color>>>
+    constexpr Color(const C& other) : r(other.r), g(other.g), b(other.b), a(other.a) {}
+
+    // To any other color type constructible from four channels
+    template <typename C, typename = std::enable_if_t<!std::is_same_v<C, Color> &&
+                                                      std::is_constructible_v<C, uint8_t, uint8_t, uint8_t, uint8_t>>>
+    constexpr operator C() const { return C(r, g, b, a); }
+
+    static const Color Black;
+    static const Color White;
+    static const Color Red;
+    static const Color Green;
+    static const Color Blue;
+    static const Color Yellow;
+    static const Color Magenta;
+    static const Color Cyan;
+    static const Color Transparent;
+};
+
+inline constexpr Color Color::Black{0, 0, 0};
+inline constexpr Color Color::White{255, 255, 255};
+inline constexpr Color Color::Red{255, 0, 0};
+inline constexpr Color Color::Green{0, 255, 0};
+inline constexpr Color Color::Blue{0, 0, 255};
+inline constexpr Color Color::Yellow{255, 255, 0};
+inline constexpr Color Color::Magenta{255, 0, 255};
+inline constexpr Color Color::Cyan{0, 255, 255};
+inline constexpr Color Color::Transparent{0, 0, 0, 0};
+
+constexpr bool operator==(const Color& a, const Color& b) { return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a; }
+constexpr bool operator!=(const Color& a, const Color& b) { return !(a == b); }
+
+/*** Time ***/
+
+// Time span in microseconds
+class Time {
+public:
+    constexpr Time() = default;
+
+    constexpr float asSeconds() const { return static_cast<float>(count) / 1000000.0f; }
+    constexpr int32_t asMilliseconds() const { return static_cast<int32_t>(count / 1000); }
+    constexpr int64_t asMicroseconds() const { return count; }
+
+    static const Time Zero;
+
+private:
+    friend constexpr Time seconds(float amount);
+    friend constexpr Time milliseconds(int32_t amount);
+    friend constexpr Time microseconds(int64_t amount);
+
+    constexpr explicit Time(int64_t count) : count(count) {}
+
+    int64_t count = 0;
+};
+
+constexpr Time seconds(float amount) { return Time(static_cast<int64_t>(amount * 1000000.0f)); }
+constexpr Time milliseconds(int32_t amount) { return Time(static_cast<int64_t>(amount) * 1000); }
+constexpr Time microseconds(int64_t amount) { return Time(amount); }
+
+inline constexpr Time Time::Zero{};
+
+constexpr Time operator-(Time a) { return microseconds(-a.asMicroseconds()); }
+constexpr Time operator+(Time a, Time b) { return microseconds(a.asMicroseconds() + b.asMicroseconds()); }
+constexpr Time operator-(Time a, Time b) { return microseconds(a.asMicroseconds() - b.asMicroseconds()); }
+constexpr Time operator*(Time a, float s) { return seconds(a.asSeconds() * s); }
+constexpr Time operator*(Time a, int64_t s) { return microseconds(a.asMicroseconds() * s); }
+constexpr Time operator/(Time a, float s) { return seconds(a.asSeconds() / s); }
+constexpr Time operator/(Time a, int64_t s) { return microseconds(a.asMicroseconds() / s); }
+constexpr float operator/(Time a, Time b) { return static_cast<float>(a.asMicroseconds()) / static_cast<float>(b.asMicroseconds()); }
+constexpr Time& operator+=(Time& a, Time b) { return a = a + b; }
+constexpr Time& operator-=(Time& a, Time b) { return a = a - b; }
+constexpr bool operator==(Time a, Time b) { return a.asMicroseconds() == b.asMicroseconds(); }
+constexpr bool operator!=(Time a, Time b) { return a.asMicroseconds() != b.asMicroseconds(); }
+constexpr bool operator<(Time a, Time b) { return a.asMicroseconds() < b.asMicroseconds(); }
+constexpr bool operator>(Time a, Time b) { return a.asMicroseconds() > b.asMicroseconds(); }
+constexpr bool operator<=(Time a, Time b) { return a.asMicroseconds() <= b.asMicroseconds(); }
+constexpr bool operator>=(Time a, Time b) { return a.asMicroseconds() >= b.asMicroseconds(); }
+
+// Wall clock on the monotonic system clock
+class Clock {
+public:
+    Clock() : start(std::chrono::steady_clock::now()) {}
+
+    // Time since construction or the last restart
+    Time getElapsedTime() const {
+        return microseconds(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Elapsed time, then start again from zero
+    Time restart() {
+        auto now = std::chrono::steady_clock::now();
+        Time elapsed = microseconds(std::chrono::duration_cast<std::chrono::microseconds>(now - start).count());
+        start = now;
+        return elapsed;
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace sim
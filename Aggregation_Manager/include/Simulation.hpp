@@ -2,6 +2,9 @@
 
 #include <vector>
 #include <queue>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -10,7 +13,9 @@
 #include <iostream>
 #include <yaml-cpp/yaml.h>
 #include <atomic>
+#include <memory>
 #include <cmath>
+#include <limits>
 #include <mongocxx/client.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
 #include <mongocxx/instance.hpp>
@@ -18,14 +23,21 @@
 
 #include "Agent.hpp"
 #include "Region.hpp"
+#include "RegionIndex.hpp"
 #include "ThreadPool.hpp"
 #include "SharedBuffer.hpp"
 #include "Obstacle.hpp"
 #include "Utilities.hpp"
 #include "Logging.hpp"
 #include "CollisionGrid.hpp"
+#include "SpatialQuery.hpp"
 #include "Sensor.hpp"
 #include "Quadtree.hpp"
+#include "Random.hpp"
+#include "ScenarioData.hpp"
+#include "SimulationClock.hpp"
+#include "Tile.hpp"
+#include "DistributedPartition.hpp"
 // #include "QuadtreeSnapshot.hpp"
 
 /**************************************/
@@ -42,15 +54,13 @@ public:
         SharedBuffer<agentBufferFrameType>& agentBuffer,
         SharedBuffer<sensorBufferFrameType>& sensorBuffer,
         // std::unordered_map<std::string, std::shared_ptr<SharedBuffer<std::shared_ptr<QuadtreeSnapshot::Node>>>> sensorBuffers,
-        std::atomic<float>& currentSimulationTimeStep, const YAML::Node& config);
+        std::atomic<float>& currentSimulationTimeStep, const YAML::Node& config,
+        std::shared_ptr<const ScenarioData> scenarioData = nullptr); // Parsed from config if not shared
     ~Simulation();
     void run();
     void update();
     float getCurrentFrameRate();
     void loadConfiguration();
-    void loadAgentsAttributes();
-    void loadRegionsAttributes();
-    void loadObstacles();
     void initializeGrid();
     void initializeAdaptiveGrid();
     void initializeDatabase();
@@ -58,21 +68,75 @@ public:
     void initializeRegions();
     void initializeSensors();
 
+    // Agent of a handle, nullptr if the agent has left the simulation
+    Agent* getAgent(AgentHandle handle);
+
+    // Neighbour queries on this frame's collision grid (of the tile containing a position)
+    SpatialQuery getSpatialQuery(const sim::Vector2f& position) const;
+
+    // Signed distance to the nearest obstacle and the direction away from it (distance field, O(1))
+    float getObstacleClearance(const sim::Vector2f& position, sim::Vector2f& repulsion) const;
+
+    // MongoDB driver instance, created once per process and shared by all simulations
+    static mongocxx::instance& getMongoInstance();
+
+    // Binary checkpoint of the complete simulation state (agents, random streams, clock, sensors)
+    bool saveCheckpoint(const std::string& path) const;
+    bool loadCheckpoint(const std::string& path);
+
 private:
     void postMetadata();
     void postData(const std::vector<Agent>& agents);
+    void updateVelocities(VelocityNoiseBatch& batch);
+    void addAgent(Agent agent);
+    void removeAgent(size_t index);
+    struct AgentTypePlan {
+        const std::string* type;
+        const Agent::AgentTypeAttributes* attributes;
+        sim::Color color;
+        uint32_t begin; // First agent index of the type
+        uint32_t end;
+    };
+    void createAgents(const std::vector<std::pair<std::string, int>>& typeCounts);
+    Agent createAgent(const AgentTypePlan& plan, uint32_t index) const;
+    void initializeSpawning();
+    void spawnAgents();
+    void spawnAgent(const std::string& type);
+    void initializeTiles();
+    void updateTiles();
+    void migrateAgents();
+    void exchangeGhosts(Tile& tile);
+    void forEachTile(const std::function<void(Tile&)>& function);
+    uint32_t getTileIndex(const sim::Vector2f& position) const;
+    void initializeDistributed();
+    sim::Vector2i getSleepCell(const sim::Vector2f& position) const;
+    bool isNearMotion(const sim::Vector2f& position) const;
+    bool shouldSleep(Agent& agent);
+    void updateSleep();
+    void sleepAgent(size_t index);
+    void wakeAgent(Agent& agent);
+    void wakeAllAgents();
+    void resumeAgents(const std::vector<size_t>& candidates, const SpatialQuery& neighbours);
+    void checkObstacleCollisions(const std::vector<size_t>& moving, const std::vector<size_t>& stopped, SweptCircleBatch& sweeps);
+    void exchangeAgents();
+    void updateObservedAreas();
+    bool isObserved(const Agent& agent) const;
+    bool updateBackground(Agent& agent);
+    float getUpdateTime(Agent& agent);
+    bool ownsPosition(const sim::Vector2f& position) const { return !partition || partition->owns(position); }
      // Simulation parameters
     // ThreadPool threadPool;
     std::atomic<float>& currentSimulationTimeStep;
     const YAML::Node& config;
     int numThreads;
+    uint64_t seed; // Key of all random streams
 
     // Timing parameters
     float timeStep;
     size_t maxFrames;
     int targetSimulationTime;
-    sf::Time simulationRealTime = sf::Time::Zero;
-    sf::Time simulationTime = sf::Time::Zero;
+    sim::Time simulationRealTime = sim::Time::Zero;
+    SimulationClock clock; // Simulation time in integer ticks of timeStep
     std::string datetime;
     std::chrono::system_clock::time_point timestamp;
 
@@ -88,10 +152,17 @@ private:
     int numRegionTypes;
     int numRegions;
     std::vector<Region> regions;
+    RegionIndex regionIndex;
     std::vector<Agent> agents;
+    AgentHandleTable agentHandles;
     float waypointDistance;
-    std::unordered_map<std::string, Agent::AgentTypeAttributes> agentTypeAttributes;
-    std::unordered_map<std::string, Region::RegionTypeAttributes> regionTypeAttributes;
+    static constexpr size_t agentChunkSize = 4096; // Agents per initialization task
+    std::shared_ptr<const ScenarioData> scenarioData; // Taxonomies and obstacles (read-only, may be shared)
+
+    // Velocity noise (shared by all agents) and batch buffers of the moving agents
+    PerlinNoise velocityNoise;
+    VelocityNoiseBatch velocityBatch;
+    SweptCircleBatch obstacleSweeps; // Paths of the agents checked against the obstacle index
 
 
     // Shared buffer reference
@@ -99,26 +170,72 @@ private:
     SharedBuffer<agentBufferFrameType>& agentBuffer;
     SharedBuffer<sensorBufferFrameType>& sensorBuffer;
 
-    // Obstacles
-    std::vector<Obstacle> obstacles;
-
     // Grid
     Grid collisionGrid;
     float collisionGridCellSize = 100.0f;
 
+    // Sleeping agents: stopped agents without motion nearby skip integration, noise and collision checks
+    int sleepAfterFrames = 0;   // Frames an agent stays stopped before it may sleep, 0 disables sleeping
+    uint64_t maxSleepTicks = 0; // Sleepers are woken after this many ticks to check their way again
+    std::unordered_map<sim::Vector2i, std::vector<AgentHandle>, Vector2iHash> sleepGrid; // Sleepers by collision cell
+    std::unordered_set<sim::Vector2i, Vector2iHash> movingCells; // Cells with moving agents at the end of the last frame
+    std::deque<std::pair<uint64_t, AgentHandle>> sleepQueue;   // Wake-up ticks in the order agents fell asleep
+    std::vector<size_t> sleepCandidates;
+    std::vector<size_t> resumeCandidates; // Stopped agents that may resume after the collision checks
+    size_t numSleeping = 0;
+
+    // Level of detail: agents outside every observed area take coarse steps without noise and collision checks
+    uint64_t lodInterval = 1;  // Ticks between the updates of a background agent, 1 disables the level of detail
+    float lodMargin = 0.0f;    // Meters around the observed areas that are still updated at full detail
+    std::vector<sim::FloatRect> observedAreas; // Sensor detection areas and the viewport, extended by the margin
+
+    // Spatial decomposition (no tiles: the whole area is updated by the simulation thread)
+    std::vector<Tile> tiles;
+    int tileColumns = 1;
+    int tileRows = 1;
+    float tileHalo = 0.0f;                 // Meters around a tile in which neighbour agents are ghosts
+    std::unique_ptr<ThreadPool> tilePool;  // Workers of the tile updates, none if single-threaded
+    std::vector<uint32_t> agentTiles;      // Tile of each agent during a migration
+    std::vector<uint32_t> migrationOrder;  // Source indices in tile order
+    std::vector<size_t> tileCounts;
+    std::vector<Agent> migrationBuffer;    // Agent vector being rebuilt in tile order
+
+    // Distributed run: the strip of this rank, agents crossing to or near the neighbouring strips
+    std::unique_ptr<DistributedPartition> partition;
+    std::vector<size_t> departures;
+    std::vector<Agent> arrivals;
+    std::vector<Agent> remoteGhosts;       // Agents of the neighbouring ranks within the halo
+
     // Scenario
     std::string scenario;
 
+    // Continuous scenario: Poisson inflow per agent type from start corridors (or the edges)
+    struct SpawnSource {
+        std::string type;
+        float rate;            // Agents per second
+        float nextSpawnTime;   // Simulation time of the next arrival in seconds
+    };
+    std::vector<SpawnSource> spawnSources;
+    std::vector<sim::FloatRect> startCorridors;
+    std::vector<sim::FloatRect> endCorridors;
+    std::vector<Agent> agentPool; // Removed agents recycled for new arrivals
+    bool recycleAgents = false;
+    Philox4x32 spawnGenerator;
+
     // MongoDB
     std::string dbUri;
     std::string databaseName;
     std::string collectionName;
     std::shared_ptr<mongocxx::client> client;
-    mongocxx::instance instance;
     mongocxx::collection collection; // For agent data storage
     std::vector<std::vector<bsoncxx::document::value>> documentBuffer;
     bool clearDatabase = false;
 
     // Sensors
     std::vector<std::unique_ptr<Sensor>> sensors;
+
+    // Checkpoints
+    uint64_t checkpointInterval = 0;              // Ticks between checkpoints, 0 if disabled
+    std::string checkpointOutput = "checkpoint";  // Files <output>_<tick>.bin
+    std::string checkpointRestore;                // Checkpoint to start from, empty for a new population
 };
\ No newline at end of file
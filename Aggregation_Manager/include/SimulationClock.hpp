@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "SimTypes.hpp"
+
+/*
+
+Simulation clock based on an integer tick counter
+
+The configured start datetime is parsed once into an epoch; timestamps are the epoch
+plus tick * tick duration in whole microseconds, so no time is accumulated in floating
+point and day-long runs do not drift. Periodic work (sensors) runs on exact tick
+multiples.
+
+*/
+
+class SimulationClock {
+public:
+    SimulationClock() = default;
+
+    // Start at a datetime "YYYY-MM-DDTHH:MM:SS" (local time, now if empty) with a fixed time step in seconds
+    SimulationClock(const std::string& datetime, float timeStep);
+
+    void advance() { ++tick; }
+
+    uint64_t getTick() const { return tick; }
+    int64_t getTickMicroseconds() const { return tickMicroseconds; }
+    float getTimeStep() const { return static_cast<float>(tickMicroseconds) * 1e-6f; }
+
+    // Elapsed simulation time
+    double getSeconds() const { return static_cast<double>(tick) * static_cast<double>(tickMicroseconds) * 1e-6; }
+    sim::Time getTime() const { return sim::microseconds(static_cast<int64_t>(tick) * tickMicroseconds); }
+
+    // Timestamp of the current tick
+    std::chrono::system_clock::time_point getTimestamp() const {
+        return epoch + std::chrono::microseconds(static_cast<int64_t>(tick) * tickMicroseconds);
+    }
+
+    // Timestamp of the previous tick (sensors run before the agents move, so they observe that tick)
+    std::chrono::system_clock::time_point getPreviousTimestamp() const {
+        return epoch + std::chrono::microseconds(static_cast<int64_t>(tick > 0 ? tick - 1 : 0) * tickMicroseconds);
+    }
+
+    // Ticks per period of a frequency in Hz (first tick at or after the period, at least one)
+    uint64_t getTicksPerPeriod(double frequency) const;
+
+private:
+    std::chrono::system_clock::time_point epoch;
+    int64_t tickMicroseconds = 1;
+    uint64_t tick = 0;
+};
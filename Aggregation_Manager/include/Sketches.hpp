@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+
+Mergeable sketches for the approximate aggregation mode
+
+CountMinSketch estimates counts per key with an overestimate of at most epsilon * N
+(N = sum of all counts) with probability 1 - delta. HyperLogLog estimates the number
+of distinct keys with a relative standard error of about 1.04 / sqrt(2^precision).
+Sketches with the same parameters can be merged, e.g. sensor-level into region-level.
+
+*/
+
+// 64-bit finalizer (splitmix64) used to hash keys for both sketches
+inline uint64_t mixHash(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+class CountMinSketch {
+public:
+    CountMinSketch() = default;
+    CountMinSketch(double epsilon, double delta);
+
+    void add(uint64_t key, uint32_t count = 1);
+    uint32_t estimate(uint64_t key) const;
+
+    // Add the counters of a sketch with the same dimensions, false if they differ
+    bool merge(const CountMinSketch& other);
+    void clear();
+
+    bool empty() const { return counters.empty(); }
+    size_t getWidth() const { return width; }
+    size_t getDepth() const { return depth; }
+
+private:
+    size_t getIndex(uint64_t key, size_t row) const;
+
+    size_t width = 0;
+    size_t depth = 0;
+    std::vector<uint32_t> counters; // depth rows of width counters
+};
+
+class HyperLogLog {
+public:
+    HyperLogLog() = default;
+    explicit HyperLogLog(int precision); // 4 to 18 bits of register index
+
+    void add(uint64_t key);
+    double estimate() const;
+
+    // Keep the maximum of both registers, false if the precisions differ
+    bool merge(const HyperLogLog& other);
+    void clear();
+
+    bool empty() const { return registers.empty(); }
+    int getPrecision() const { return precision; }
+
+private:
+    int precision = 0;
+    std::vector<uint8_t> registers;
+};
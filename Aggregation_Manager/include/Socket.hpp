@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Logging.hpp"
+
+/*
+
+Blocking stream sockets with length-prefixed messages
+
+Endpoints are "unix:/path/to/socket" (Unix domain socket, one machine) or
+"tcp:host:port" (TCP, also across machines). A message is a 32-bit type and a 64-bit
+payload length followed by the payload, in the byte order of the machine (all
+processes of a run are expected to share an architecture). Failures are logged and
+reported by return values; a socket that failed is closed.
+
+*/
+
+class Socket {
+public:
+    Socket() = default;
+    explicit Socket(int descriptor) : descriptor(descriptor) {}
+    ~Socket();
+
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+    Socket(Socket&& other) noexcept;
+    Socket& operator=(Socket&& other) noexcept;
+
+    // Listening socket on an endpoint (replaces a stale Unix socket file)
+    static Socket listen(const std::string& endpoint);
+
+    // Connection to an endpoint, retried while the other process starts up
+    static Socket connect(const std::string& endpoint, int attempts = 300, int retryMilliseconds = 100);
+
+    // Next connection of a listening socket
+    Socket accept() const;
+
+    bool valid() const { return descriptor >= 0; }
+    void close();
+
+    // Whole messages: false if the connection failed or was closed by the peer
+    bool sendMessage(uint32_t type, const std::string& payload);
+    bool receiveMessage(uint32_t& type, std::string& payload);
+
+private:
+    bool sendAll(const char* data, size_t size);
+    bool receiveAll(char* data, size_t size);
+
+    int descriptor = -1;
+    std::string unixPath; // Removed when a listening Unix socket closes
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "Agent.hpp"
+#include "CollisionGrid.hpp"
+
+/*
+
+Spatial neighbour queries backed by the collision grid
+
+A lightweight view of a collision grid after it was filled for the frame. Queries only
+visit the cells overlapping the query area, so their cost depends on the local density
+instead of the population. Ghosts (copies of agents of other tiles or ranks) are
+returned like the grid's own agents, and so are agents not moved this frame (sleeping or
+updated in the background), which take no part in the collision checks. In tiled runs each tile grid covers the tile and
+its halo, so queries are exact up to the halo width around the tile.
+
+- Rectangle query: agents whose position lies in a rectangle
+- Radius query: agents within a distance of a point
+- k-nearest query: the k agents closest to a point, in increasing distance
+
+*/
+
+class SpatialQuery {
+public:
+    explicit SpatialQuery(const Grid& grid) : grid(&grid) {}
+
+    // Visit the agents in a rectangle until the visitor returns false, false if stopped early
+    template <typename Visitor>
+    bool forEachInRect(const sim::FloatRect& area, Visitor&& visit) const;
+
+    void findInRect(const sim::FloatRect& area, std::vector<const Agent*>& result) const;
+    void findInRadius(const sim::Vector2f& center, float radius, std::vector<const Agent*>& result, const Agent* exclude = nullptr) const;
+    void findNearest(const sim::Vector2f& center, size_t k, std::vector<const Agent*>& result, const Agent* exclude = nullptr) const;
+
+    // Largest body or buffer zone radius in the grid (reach of overlap queries)
+    float getMaxAgentRadius() const { return grid->maxAgentRadius; }
+
+private:
+    const Grid* grid;
+};
+
+template <typename Visitor>
+bool SpatialQuery::forEachInRect(const sim::FloatRect& area, Visitor&& visit) const {
+
+    sim::Vector2f low(std::min(area.position.x, area.position.x + area.size.x), std::min(area.position.y, area.position.y + area.size.y));
+    sim::Vector2f high(std::max(area.position.x, area.position.x + area.size.x), std::max(area.position.y, area.position.y + area.size.y));
+    auto inArea = [&low, &high](const Agent* agent) {
+        return agent->position.x >= low.x && agent->position.x <= high.x && agent->position.y >= low.y && agent->position.y <= high.y;
+    };
+    auto visitCell = [&inArea, &visit](const GridCell& cell) {
+        for (const Agent* agent : cell.agents) {
+            if (inArea(agent) && !visit(agent)) return false;
+        }
+        for (const Agent* ghost : cell.ghosts) {
+            if (inArea(ghost) && !visit(ghost)) return false;
+        }
+        for (const Agent* agent : cell.statics) {
+            if (inArea(agent) && !visit(agent)) return false;
+        }
+        return true;
+    };
+
+    // Cells overlapping the area, or all occupied cells if those are fewer
+    sim::Vector2i first = grid->getGridCellIndex(low);
+    sim::Vector2i last = grid->getGridCellIndex(high);
+    size_t numCells = static_cast<size_t>(last.x - first.x + 1) * static_cast<size_t>(last.y - first.y + 1);
+    if (numCells > grid->cells.size()) {
+        for (const auto& [cellIndex, cell] : grid->cells) {
+            if (cellIndex.x >= first.x && cellIndex.x <= last.x && cellIndex.y >= first.y && cellIndex.y <= last.y && !visitCell(cell)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (int y = first.y; y <= last.y; ++y) {
+        for (int x = first.x; x <= last.x; ++x) {
+            auto cell = grid->cells.find(sim::Vector2i(x, y));
+            if (cell != grid->cells.end() && !visitCell(cell->second)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "Agent.hpp"
+#include "CollisionGrid.hpp"
+#include "ObstacleIndex.hpp"
+
+/*
+
+Spatial decomposition of the simulation area into tiles
+
+The area is split into columns x rows tiles. The agent vector is ordered by tile, so
+a tile owns the contiguous index range [begin, end) and updates it independently of
+the other tiles: positions, velocity noise and collisions, with its own collision
+grid. Agents near a tile edge are exchanged as ghosts: each tile receives copies of
+the neighbour agents within the halo width around its bounds and checks its own
+agents against them, so that no tile writes to agents of another tile. Agents that
+crossed an edge migrate between tiles at the start of the next frame (a stable
+counting sort of the agent vector by tile).
+
+*/
+
+// Coordinates and results of a batched velocity noise evaluation
+struct VelocityNoiseBatch {
+    std::vector<size_t> agents; // Indices of the moving agents
+    std::vector<float> x, y, time, out;
+};
+
+// Tile of the spatial decomposition
+struct Tile {
+    Tile(const sim::FloatRect& bounds, float halo, float cellSize)
+        : bounds(bounds),
+          haloBounds({bounds.position.x - halo, bounds.position.y - halo}, {bounds.size.x + 2.0f * halo, bounds.size.y + 2.0f * halo}),
+          collisionGrid(cellSize, haloBounds) {}
+
+    sim::FloatRect bounds;
+    sim::FloatRect haloBounds;    // Bounds extended by the halo width
+    size_t begin = 0;             // Agent index range owned by the tile
+    size_t end = 0;
+    std::vector<int> neighbours;  // Adjacent tiles, including diagonals
+
+    Grid collisionGrid;
+    std::vector<size_t> borderAgents; // Own agents within the halo width of an edge
+    std::vector<size_t> sleepCandidates; // Own agents falling asleep after this frame
+    std::vector<size_t> resumeCandidates; // Own stopped agents that may resume after the collision checks
+    std::vector<Agent> ghosts;        // Copies of neighbour agents within the halo (reused buffers)
+    size_t numGhosts = 0;
+    VelocityNoiseBatch noise;
+    SweptCircleBatch obstacleSweeps;
+};
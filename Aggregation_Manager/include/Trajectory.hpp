@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "SimTypes.hpp"
+
+class CheckpointWriter;
+class CheckpointReader;
+
+/*
+
+Agent trajectory with procedural waypoints
+
+A straight route is stored as start, target and the step between waypoints, and
+waypoint i is computed on demand: start, start + step, ..., start + n * step, target
+with n = floor(distance / spacing). The next waypoint ahead of an agent is found in
+O(1) by projecting its position onto the route. Only routed paths (from path
+finding) keep their waypoints in a polyline.
+
+*/
+
+class Trajectory {
+public:
+    // Straight route with waypoints every spacing meters
+    void setStraight(sim::Vector2f start, sim::Vector2f target, float spacing);
+
+    // Routed path through explicit waypoints
+    void setPolyline(const std::vector<sim::Vector2f>& waypoints);
+
+    void clear();
+
+    // Number of waypoints, including start and target
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+    bool isRouted() const { return !polyline.empty(); }
+
+    sim::Vector2f operator[](size_t index) const;
+
+    // Index of the first waypoint ahead of a position in the direction of a velocity, -1 if none
+    int getNextWaypointIndex(sim::Vector2f position, sim::Vector2f velocity) const;
+
+    void save(CheckpointWriter& writer) const;
+    void load(CheckpointReader& reader);
+
+private:
+    sim::Vector2f start;
+    sim::Vector2f target;
+    sim::Vector2f direction;       // Unit vector from start to target
+    sim::Vector2f step;            // Offset between intermediate waypoints
+    float spacing = 0.0f;
+    float length = 0.0f;          // Distance from start to target
+    int numIntermediate = -1;     // Waypoints between start and target, -1 without a straight route
+    std::vector<sim::Vector2f> polyline;
+};
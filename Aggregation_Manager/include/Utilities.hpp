@@ -1,6 +1,5 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
 #include <iostream>
 #include <iomanip>
 #include <unordered_map>
@@ -13,24 +12,30 @@
 #include <sstream>
 #include <cmath>
 
+#include "SimTypes.hpp"
+#include "Random.hpp"
+
 
 /*******************************/
 /********** UTILITIES **********/
 /*******************************/
 
 std::string generateUUID();
+void generateUUID(std::string& uuidString);
+void generateUUID(std::string& uuidString, Philox4x32& generator);
 std::string generateISOTimestamp();
 std::string generateISOTimestampString(const std::chrono::system_clock::time_point& timestamp);
 bsoncxx::types::b_date generateBsonDate(const std::string& dateTimeString);
-std::chrono::system_clock::time_point generateISOTimestamp(sf::Time simulationWallTime, const std::string& dateTimeString);
+std::chrono::system_clock::time_point generateISOTimestamp(sim::Time simulationWallTime, const std::string& dateTimeString);
 float generateRandomNumberFromTND(float mean, float stddev, float min, float max);
-sf::Vector2f generateRandomVelocityVector(float mu, float sigma, float min, float max);
-// std::string generateISOTimestamp(sf::Time simulationWallTime);
+float generateRandomNumberFromTND(float mean, float stddev, float min, float max, Philox4x32& generator);
+sim::Vector2f generateRandomVelocityVector(float mu, float sigma, float min, float max);
+// std::string generateISOTimestamp(sim::Time simulationWallTime);
 // Structure to hash a 2D vector for use in unordered_map
 struct Vector2iHash {
-    std::size_t operator()(const sf::Vector2i& v) const {
+    std::size_t operator()(const sim::Vector2i& v) const {
         std::hash<int> hasher;
         return hasher(v.x) ^ (hasher(v.y) << 1); // Combine hash values of x and y
     }
 };
-sf::Color stringToColor(std::string colorStr);
\ No newline at end of file
+sim::Color stringToColor(std::string colorStr);
\ No newline at end of file
@@ -4,13 +4,14 @@
 #include <mongocxx/uri.hpp>
 #include <bsoncxx/json.hpp>
 #include <iostream>
+#include <algorithm>
 
 #include "../include/AdaptiveGridBasedSensor.hpp"
 
 // Base constructor for simulation
 AdaptiveGridBasedSensor::AdaptiveGridBasedSensor(
     float frameRate,
-    sf::FloatRect detectionArea,
+    sim::FloatRect detectionArea,
     float cellSize,
     int maxDepth,
     const std::string &databaseName,
@@ -31,8 +32,8 @@ AdaptiveGridBasedSensor::AdaptiveGridBasedSensor(
 
 // Alternative constructor for rendering
 AdaptiveGridBasedSensor::AdaptiveGridBasedSensor(
-    sf::FloatRect detectionArea, 
-    sf::Color detectionAreaColor, 
+    sim::FloatRect detectionArea, 
+    sim::Color detectionAreaColor, 
     float cellSize, 
     int maxDepth,
     bool showGrid,
@@ -58,10 +59,10 @@ AdaptiveGridBasedSensor::~AdaptiveGridBasedSensor() {
 }
 
 // Update grid-based agent detection and output one gridData entry per frame
-void AdaptiveGridBasedSensor::update(std::vector<Agent>& agents, float timeStep, std::chrono::system_clock::time_point timestamp) {
+void AdaptiveGridBasedSensor::update(std::vector<Agent>& agents, const SimulationClock& clock) {
     
-    // Update current timestamp
-    this->timestamp = timestamp;
+    // Update current timestamp, the time of the agent states
+    this->timestamp = clock.getPreviousTimestamp();
     
     // Clear data storage
     dataStorage.clear();
@@ -70,15 +71,13 @@ void AdaptiveGridBasedSensor::update(std::vector<Agent>& agents, float timeStep,
     // // Get the current timestamp as a string
     // auto currentTime = timestamp;
 
-    // Update the time since the last update
-    timeSinceLastUpdate += timeStep;
-
     // Update the estimated velocities at the specified frame rate
-    if (timeSinceLastUpdate >= 1.0f / frameRate) {
+    if (isUpdateDue(clock)) {
 
         // Clear the grid data
         // adaptiveGridData.clear();
         adaptiveGridData.clear();
+        cellAgentHashes.clear();
         adaptiveGrid.agents.clear();
         adaptiveGrid.positions.clear();
 
@@ -97,7 +96,14 @@ void AdaptiveGridBasedSensor::update(std::vector<Agent>& agents, float timeStep,
         if(hasAgents) {
 
             // Generate split sequence
-            adaptiveGrid.splitFromPositions();
+            if (splitMode == "privacy") {
+
+                // Rebuild the tree every frame since privacy splits can coarsen again
+                adaptiveGrid.clear();
+                adaptiveGrid.splitFromCellIds(computePrivacyConstrainedCells());
+            } else {
+                adaptiveGrid.splitFromPositions();
+            }
             
             for (Agent* agentPtr : adaptiveGrid.agents) {
                 Agent& agent = *agentPtr;
@@ -111,6 +117,43 @@ void AdaptiveGridBasedSensor::update(std::vector<Agent>& agents, float timeStep,
                 // Increment the count of the agent type and total agents in the cell
                 adaptiveGridData[cellId].agentTypeCount[agent.type]++;
                 adaptiveGridData[cellId].totalAgents++;
+
+                // Keep the agent hashes per cell for the distinct agents of the approximate aggregation
+                if (aggregationManager.approximate) {
+                    cellAgentHashes[cellId].push_back(std::hash<std::string>{}(agent.agentId));
+                }
+            }
+
+            // Suppress cells that still violate their privacy bounds (only unsplittable base cells can)
+            if (splitMode == "privacy") {
+                for (auto it = adaptiveGridData.begin(); it != adaptiveGridData.end();) {
+                    CellConstraints constraints = getCellConstraints(it->first);
+                    if (it->second.totalAgents < constraints.kAnonymity ||
+                        static_cast<int>(it->second.agentTypeCount.size()) < constraints.lDiversity) {
+                        DEBUG_MSG("Suppressing non-compliant cell " << it->first);
+                        it = adaptiveGridData.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+
+            // Stream the cell counts into the temporal aggregation windows of their region and the roll-up
+            if (aggregationManager.enabled || aggregationManager.rollupEnabled) {
+                for (const auto& [cellId, cellData] : adaptiveGridData) {
+                    float windowLength = aggregationManager.defaultWindowLength;
+                    float windowHop = aggregationManager.defaultWindowHop;
+                    if (aggregationManager.enabled) {
+                        CellConstraints constraints = getCellConstraints(cellId);
+                        if (constraints.maxWindow > 0.0f) {
+                            windowLength = constraints.maxWindow;
+                            windowHop = constraints.minWindow;
+                        }
+                    }
+                    auto agentHashes = cellAgentHashes.find(cellId);
+                    aggregationManager.ingest(cellId, cellData.agentTypeCount, cellData.totalAgents, windowLength, windowHop,
+                                              agentHashes != cellAgentHashes.end() ? &agentHashes->second : nullptr);
+                }
             }
             
             // Create a shared pointer to the timestamped current cell ids
@@ -119,9 +162,6 @@ void AdaptiveGridBasedSensor::update(std::vector<Agent>& agents, float timeStep,
             // Write the current cell ids to the sensor buffer
             sensorBuffer.write(currentCellIdsPtr);
 
-            // Reset the time since the last update
-            timeSinceLastUpdate = 0.0f;
-
             // Push timestamped adaptive grid data to the data storage
             dataStorage.push_back({this->timestamp, adaptiveGridData});
         }
@@ -130,9 +170,143 @@ void AdaptiveGridBasedSensor::update(std::vector<Agent>& agents, float timeStep,
             auto emptyCellIdsPtr = std::make_shared<sensorFrameType>(this->timestamp, std::move(sensorFrame{}));
             sensorBuffer.write(emptyCellIdsPtr);
         }
+
+        // Emit the aggregation windows closed by this frame
+        aggregationManager.update();
     }
 }
 
+// Compute the privacy-compliant leaf cells in one bottom-up pass over the sorted leaf Morton keys
+std::unordered_set<int> AdaptiveGridBasedSensor::computePrivacyConstrainedCells() {
+
+    std::unordered_set<int> cellIds;
+    privacyKeys.clear();
+    privacyNodeStats.clear();
+
+    // Leaf key at maxDepth and type bit per agent, sorted so that every subtree is a contiguous run
+    for (Agent* agent : adaptiveGrid.agents) {
+        privacyKeys.emplace_back(static_cast<uint32_t>(adaptiveGrid.makeCell(agent->position)), getAgentTypeBit(agent->type));
+    }
+    std::sort(privacyKeys.begin(), privacyKeys.end());
+
+    // Currently open node per depth along the path of the last key (index 0 unused)
+    std::vector<uint32_t> openIds(maxDepth + 1, 0);
+    std::vector<PrivacyNodeStats> openStats(maxDepth + 1);
+    int openDepth = 0;
+
+    // Close all open levels from the deepest up to depth, folding each node into its parent
+    auto closeLevels = [&](int depth) {
+        for (int d = openDepth; d >= depth; --d) {
+            const PrivacyNodeStats& stats = openStats[d];
+            privacyNodeStats[openIds[d]] = stats;
+
+            if (d > 1) {
+                CellConstraints constraints = getCellConstraints(openIds[d]);
+                bool compliant = stats.totalAgents >= constraints.kAnonymity
+                    && __builtin_popcountll(stats.agentTypeMask) >= constraints.lDiversity
+                    && adaptiveGrid.getCellBounds(openIds[d]).size.x >= constraints.minCellSize;
+
+                PrivacyNodeStats& parent = openStats[d - 1];
+                parent.totalAgents += stats.totalAgents;
+                parent.agentTypeMask |= stats.agentTypeMask;
+                parent.childrenCompliant = parent.childrenCompliant && compliant;
+            }
+        }
+        openDepth = depth - 1;
+    };
+
+    // Bottom-up pass: every node is opened and closed exactly once
+    for (const auto& [key, agentTypeBit] : privacyKeys) {
+
+        // Find the shallowest level where the key leaves the open path
+        int depth = 1;
+        while (depth <= openDepth && openIds[depth] == Morton::ancestor(key, maxDepth, depth))
+            ++depth;
+
+        // Close the finished subtrees and open the new path down to the leaf
+        closeLevels(depth);
+        for (int d = depth; d <= maxDepth; ++d) {
+            openIds[d] = Morton::ancestor(key, maxDepth, d);
+            openStats[d] = PrivacyNodeStats{};
+        }
+        openDepth = maxDepth;
+
+        openStats[maxDepth].totalAgents++;
+        openStats[maxDepth].agentTypeMask |= agentTypeBit;
+    }
+    closeLevels(1);
+
+    // Top-down: keep a split only where every non-empty child is compliant
+    // Note: cells above the spatial maximum stay unsplit if splitting would break privacy
+    std::vector<std::pair<int, int>> stack; // Cell id, depth
+    for (int baseId = 0b1100; baseId <= 0b1111; ++baseId) {
+        if (privacyNodeStats.count(baseId))
+            stack.emplace_back(baseId, 1);
+    }
+    while (!stack.empty()) {
+        auto [cellId, depth] = stack.back();
+        stack.pop_back();
+
+        if (depth < maxDepth && privacyNodeStats[cellId].childrenCompliant) {
+            for (int childIndex = 0; childIndex < 4; ++childIndex) {
+                int childId = (cellId << 2) | childIndex;
+                if (privacyNodeStats.count(childId))
+                    stack.emplace_back(childId, depth + 1);
+            }
+        } else {
+            cellIds.insert(cellId);
+        }
+    }
+
+    return cellIds;
+}
+
+// Precompute the constraints of every region set and the region sets of all cells
+void AdaptiveGridBasedSensor::setRegionIndex(RegionIndex& regionIndex, const std::vector<Region>& regions) {
+
+    // Building the cell table can add region sets (unions), so it comes first
+    regionCells = regionIndex.buildCellTable(adaptiveGrid);
+
+    // Use the most restrictive bounds of all regions in a set
+    regionSetConstraints.assign(regionIndex.getNumRegionSets(), CellConstraints{});
+    for (size_t regionSet = 0; regionSet < regionIndex.getNumRegionSets(); ++regionSet) {
+        CellConstraints& constraints = regionSetConstraints[regionSet];
+        for (int index : regionIndex.getRegions(static_cast<int>(regionSet))) {
+            const Region& region = regions[index];
+            constraints.kAnonymity = std::max(constraints.kAnonymity, region.attributes.privacy.k_anonymity.min);
+            constraints.lDiversity = std::max(constraints.lDiversity, region.attributes.privacy.l_diversity.min);
+            constraints.minCellSize = std::max(constraints.minCellSize, region.attributes.granularities.spatial.min);
+            constraints.minWindow = std::max(constraints.minWindow, region.attributes.granularities.temporal.min);
+            constraints.maxWindow = std::max(constraints.maxWindow, region.attributes.granularities.temporal.max);
+        }
+    }
+}
+
+// Get the privacy constraints of a cell from the regions it overlaps
+AdaptiveGridBasedSensor::CellConstraints AdaptiveGridBasedSensor::getCellConstraints(int cellId) const {
+
+    if (regionCells.empty()) {
+        return CellConstraints{};
+    }
+
+    return regionSetConstraints[regionCells.getCover(cellId).regionSet];
+}
+
+// Get the bit of an agent type for the l-diversity type masks
+uint64_t AdaptiveGridBasedSensor::getAgentTypeBit(const std::string& agentType) {
+
+    auto it = agentTypeBits.find(agentType);
+    if (it == agentTypeBits.end()) {
+        if (agentTypeBits.size() >= 64) {
+            ERROR_MSG("Error: More than 64 agent types for the privacy split, ignoring " << agentType);
+            return 0;
+        }
+        it = agentTypeBits.emplace(agentType, static_cast<int>(agentTypeBits.size())).first;
+    }
+
+    return uint64_t{1} << it->second;
+}
+
 // Post metadata to the database
 void AdaptiveGridBasedSensor::postMetadata() {
 
@@ -155,7 +329,9 @@ void AdaptiveGridBasedSensor::postMetadata() {
              << "detection_area" << detectionAreaDocument
              << "frame_rate" << frameRate
              << "cell_size" << cellSize
-             << "max_depth" << maxDepth;
+             << "max_depth" << maxDepth
+             << "split_mode" << splitMode
+             << "aggregation" << aggregationManager.enabled;
 
     // Insert the metadata document into the collection
     try {
@@ -1,19 +1,34 @@
 #include "../include/Agent.hpp"
+#include "../include/Checkpoint.hpp"
+#include "../include/SpatialQuery.hpp"
 
 // Default constructor for the Agent class
 Agent::Agent(const AgentTypeAttributes& attributes) : attributes(attributes) {
 
+    resetState();
+};
+
+// Reuse a pooled agent for a new agent of a type (keeps the capacity of its strings)
+void Agent::reset(const AgentTypeAttributes& attributes) {
+
+    this->attributes = attributes;
+    trajectory.clear();
+    nextWaypointIndex = -1;
+    velocity = sim::Vector2f(0.0f, 0.0f);
+    resetState();
+}
+
+// Default states
+void Agent::resetState() {
+
     collisionPredicted = false;
     stopped = false;
     isActive = true;
     stoppedFrameCounter = 0;
+    isBackground = false;
     minBufferZoneRadius = 0.5f;
     bufferZoneRadius = minBufferZoneRadius;
-    bufferZoneColor = sf::Color::Green;
-};
-
-Agent::~Agent() {
-    trajectory.clear();
+    bufferZoneColor = sim::Color::Green;
 }
 
 // Initialize the agent with default values and calculate buffer zone radius
@@ -24,13 +39,13 @@ void Agent::setBufferZoneSize() {
 }
 
 // Calculate the velocity based on the next waypoint
-void Agent::calculateVelocity(sf::Vector2f waypoint) {
+void Agent::calculateVelocity(sim::Vector2f waypoint) {
     
     // Calculate velocity based on heading to the next waypoint
     float angle = std::atan2(waypoint.y - position.y, waypoint.x - position.x);
     
     // Calculate the heading vector
-    // sf::Vector2f heading;
+    // sim::Vector2f heading;
     heading.x = std::cos(angle);
     heading.y = std::sin(angle);
 
@@ -39,30 +54,39 @@ void Agent::calculateVelocity(sf::Vector2f waypoint) {
 }
 
 // Get the bounds of the agent's buffer zone
-sf::FloatRect Agent::getBufferZoneBounds() const {
+sim::FloatRect Agent::getBufferZoneBounds() const {
     // Note: SFML 2.6.2 and prior
-    // return sf::FloatRect({
+    // return sim::FloatRect({
     //     position.x - bufferZoneRadius,
     //     position.y - bufferZoneRadius,
     //     2 * bufferZoneRadius,
     //     2 * bufferZoneRadius}
     // );
-    return sf::FloatRect(
+    return sim::FloatRect(
         {position.x - bufferZoneRadius, position.y - bufferZoneRadius},
         {2 * bufferZoneRadius, 2 * bufferZoneRadius}
     );
 }
 
-// Update the agent's velocity based on Perlin noise
-void Agent::updateVelocity(float deltaTime, sf::Time simulationTime) {
+// Update the agent's velocity based on the shared noise field
+void Agent::updateVelocity(const PerlinNoise& noise, sim::Time simulationTime) {
     
-    // Use the agent's own Perlin noise generator to fluctuate velocity
-    float noiseX = perlinNoise.noise(position.x * attributes.velocity.noiseScale, position.y * attributes.velocity.noiseScale, simulationTime.asSeconds()) * 2.0f - 1.0f;
-    float noiseY = perlinNoise.noise(position.x * attributes.velocity.noiseScale, position.y * attributes.velocity.noiseScale, simulationTime.asSeconds() + 1000.0f) * 2.0f - 1.0f;
+    // Sample the shared noise at the agent's position, offset in time per agent
+    float x = position.x * attributes.velocity.noiseScale;
+    float y = position.y * attributes.velocity.noiseScale;
+    float time = simulationTime.asSeconds() + noiseOffset;
+    float noiseX = noise.noise(x, y, time) * 2.0f - 1.0f;
+    float noiseY = noise.noise(x, y, time + 1000.0f) * 2.0f - 1.0f;
+
+    applyVelocityNoise(noiseX, noiseY);
+}
+
+// Fluctuate the velocity by noise values in [-1, 1]
+void Agent::applyVelocityNoise(float noiseX, float noiseY) {
 
     // Apply noise to velocity
-    velocity.x = initialVelocity.x + noiseX / 3.6 * attributes.velocity.noiseFactor;
-    velocity.y = initialVelocity.y + noiseY / 3.6 * attributes.velocity.noiseFactor;
+    velocity.x = initialVelocity.x + noiseX / 3.6f * attributes.velocity.noiseFactor;
+    velocity.y = initialVelocity.y + noiseY / 3.6f * attributes.velocity.noiseFactor;
 }
 
 // Update the agent's position based on velocity
@@ -74,71 +98,28 @@ void Agent::updatePosition(float timeStep) {
 }
 
 // Get the future position of the agent at a given time
-sf::Vector2f Agent::getFuturePositionAtTime(float time) const {
+sim::Vector2f Agent::getFuturePositionAtTime(float time) const {
 
     return position + velocity * time;
 }
 
 // Calculate the trajectory based on the target position and waypoint distance
 void Agent::calculateTrajectory(float waypointDistance) {
-    
-    // Clear existing trajectory data
-    trajectory.clear();
-
-    // Add the initial position as the starting waypoint
-    trajectory.push_back(initialPosition);
-
-    // Save the initial position
-    sf::Vector2f currentPosition = initialPosition;
-
-    // Calculate total distance to target
-    double totalDistance = sqrt(pow((targetPosition.x - initialPosition.x), 2) + pow((targetPosition.y - initialPosition.y), 2));
-    
-    // Round down to the nearest integer
-    int numWaypoints = floor(totalDistance / waypointDistance);
-    
-    // If there are no waypoints, go directly to the target
-    if (numWaypoints < 1) {
-        trajectory.push_back(targetPosition);
-        return;
-    }
-    
-    // Calculate angle to the target
-    double angle = atan2(targetPosition.y - initialPosition.y, targetPosition.x - initialPosition.x); // in radians
-    
-    // Compute delta positions
-    double deltaX = waypointDistance * cos(angle);
-    double deltaY = waypointDistance * sin(angle);
-
-    // Add intermediate waypoints
-    for (int i = 0; i < numWaypoints; ++i) {
-        currentPosition.x += deltaX;
-        currentPosition.y += deltaY;
-        trajectory.push_back(currentPosition);
-    }
 
-    // Add the final target position as the last waypoint
-    trajectory.push_back(targetPosition);
+    // Straight route, waypoints are computed on demand
+    trajectory.setStraight(initialPosition, targetPosition, waypointDistance);
 }
 
-// Get the next waypoint based on the agent's trajectory
+// Get the next waypoint based on the agent's trajectory (O(1) for straight routes)
 void Agent::getNextWaypoint() {
 
-    // Get the next waypoint based on trajectory, position, and velocity
-    for (int i = 0; i < trajectory.size(); ++i) {
-        sf::Vector2f directionToWaypoint = trajectory[i] - position;
-        float dotProduct = directionToWaypoint.x * velocity.x + directionToWaypoint.y * velocity.y;
-        if (dotProduct > 0) {
-            nextWaypointIndex = i;
-            break;
-        }
-    }
+    nextWaypointIndex = trajectory.getNextWaypointIndex(position, velocity);
 }
 
 // Reset the collision state of the agent
 void Agent::resetCollisionState() {
 
-    bufferZoneColor = sf::Color::Green;
+    bufferZoneColor = sim::Color::Green;
     collisionPredicted = false;
 }
 
@@ -147,36 +128,151 @@ void Agent::stop() {
 
     // Stop the agent if it is not already stopped
     if (!stopped) {
-        velocity = sf::Vector2f(0.0f, 0.0f);
+        velocity = sim::Vector2f(0.0f, 0.0f);
         stopped = true;
-        stoppedFrameCounter = 0;
     }
 }
 
-// Check if the agent can resume movement without colliding with other agents
-bool Agent::canResume(const std::vector<Agent>& agents) {
+// Check if the agent can resume movement without overlapping the body of a neighbour
+bool Agent::canResume(const SpatialQuery& neighbours) const {
 
-    for (const auto& other : agents) {
-        if (&other == this) continue;
+    // Only agents within the largest body radius around the agent's body can overlap it
+    float reach = bodyRadius + neighbours.getMaxAgentRadius();
+    sim::FloatRect area({position.x - reach, position.y - reach}, {2.0f * reach, 2.0f * reach});
 
-        float dx = position.x - other.position.x;
-        float dy = position.y - other.position.y;
-        float distance = std::sqrt(dx * dx + dy * dy);
-        
-        if (distance < bodyRadius + other.bodyRadius) {
-            
-            return false;
-        }
-    }
-    return true;
+    return neighbours.forEachInRect(area, [this](const Agent* other) {
+        if (other == this) return true;
+
+        float dx = position.x - other->position.x;
+        float dy = position.y - other->position.y;
+        float radius = bodyRadius + other->bodyRadius;
+
+        return dx * dx + dy * dy >= radius * radius;
+    });
 }
 
 // Resume the agent's movement if there are no collisions
-void Agent::resume(const std::vector<Agent>& agents) {
+void Agent::resume(const SpatialQuery& neighbours) {
+
+    if (stopped && canResume(neighbours)) {
+        resume();
+    }
+}
+
+// Resume the agent's movement unconditionally
+void Agent::resume() {
 
-    // Resume the agent if it is stopped and has been stopped for at least 20 frames
     if (stopped) {
         velocity = initialVelocity;
         stopped = false;
     }
-}
\ No newline at end of file
+}
+
+// Checkpoint of the complete agent state
+void Agent::save(CheckpointWriter& writer) const {
+
+    // Identity and type attributes
+    writer.write(handle);
+    writer.write(agentId);
+    writer.write(sensorId);
+    writer.write(type);
+    writer.write(color);
+    writer.write(initialColor);
+    writer.write(priority);
+    writer.write(bodyRadius);
+    writer.write(attributes.probability);
+    writer.write(attributes.priority);
+    writer.write(attributes.bodyRadius);
+    writer.write(attributes.color);
+    writer.write(attributes.velocity);
+    writer.write(attributes.acceleration);
+    writer.write(attributes.lookAheadTime);
+    writer.write(attributes.spawnRate);
+    writer.write(timestamp);
+
+    // Kinematics
+    writer.write(position);
+    writer.write(initialPosition);
+    writer.write(targetPosition);
+    writer.write(heading);
+    writer.write(theta);
+    writer.write(velocity);
+    writer.write(initialVelocity);
+    writer.write(velocityMagnitude);
+    writer.write(acceleration);
+    writer.write(initialAcceleration);
+    writer.write(accelerationMagnitude);
+
+    // Trajectory
+    trajectory.save(writer);
+    writer.write(waypointDistance);
+    writer.write(nextWaypointIndex);
+
+    // Buffer zone, collision states and noise
+    writer.write(bufferZoneRadius);
+    writer.write(minBufferZoneRadius);
+    writer.write(bufferZoneColor);
+    writer.write(collisionPredicted);
+    writer.write(stopped);
+    writer.write(isActive);
+    writer.write(stoppedFrameCounter);
+    writer.write(lookAheadTime);
+    writer.write(noiseOffset);
+    writer.write(lastUpdateTick);
+}
+
+void Agent::load(CheckpointReader& reader) {
+
+    // Identity and type attributes
+    reader.read(handle);
+    reader.read(agentId);
+    reader.read(sensorId);
+    reader.read(type);
+    reader.read(color);
+    reader.read(initialColor);
+    reader.read(priority);
+    reader.read(bodyRadius);
+    reader.read(attributes.probability);
+    reader.read(attributes.priority);
+    reader.read(attributes.bodyRadius);
+    reader.read(attributes.color);
+    reader.read(attributes.velocity);
+    reader.read(attributes.acceleration);
+    reader.read(attributes.lookAheadTime);
+    reader.read(attributes.spawnRate);
+    reader.read(timestamp);
+
+    // Kinematics
+    reader.read(position);
+    reader.read(initialPosition);
+    reader.read(targetPosition);
+    reader.read(heading);
+    reader.read(theta);
+    reader.read(velocity);
+    reader.read(initialVelocity);
+    reader.read(velocityMagnitude);
+    reader.read(acceleration);
+    reader.read(initialAcceleration);
+    reader.read(accelerationMagnitude);
+
+    // Trajectory
+    trajectory.load(reader);
+    reader.read(waypointDistance);
+    reader.read(nextWaypointIndex);
+
+    // Buffer zone, collision states and noise
+    reader.read(bufferZoneRadius);
+    reader.read(minBufferZoneRadius);
+    reader.read(bufferZoneColor);
+    reader.read(collisionPredicted);
+    reader.read(stopped);
+    reader.read(isActive);
+    reader.read(stoppedFrameCounter);
+    reader.read(lookAheadTime);
+    reader.read(noiseOffset);
+
+    // Version 1 checkpoints have no level of detail, the agents were updated in the saved tick
+    if (reader.getVersion() >= 2) {
+        reader.read(lastUpdateTick);
+    }
+}
@@ -10,7 +10,7 @@
 // Constructor
 AgentBasedSensor::AgentBasedSensor(
     float frameRate,
-    sf::FloatRect detectionArea,
+    sim::FloatRect detectionArea,
     const std::string &databaseName,
     const std::string &collectionName,
     std::shared_ptr<mongocxx::client> client,
@@ -25,8 +25,8 @@ AgentBasedSensor::AgentBasedSensor(
 
 // Alternative constructor for rendering
 AgentBasedSensor::AgentBasedSensor(
-    sf::FloatRect detectionArea,
-    sf::Color detectionAreaColor,
+    sim::FloatRect detectionArea,
+    sim::Color detectionAreaColor,
     SharedBuffer<sensorBufferFrameType>& sensorBuffer
 ) : Sensor(detectionArea, detectionAreaColor, sensorBuffer), 
     sensorBuffer(sensorBuffer) {
@@ -38,21 +38,18 @@ AgentBasedSensor::AgentBasedSensor(
 AgentBasedSensor::~AgentBasedSensor() {}
 
 // Update method for agent-based sensor, taking snapshot of agents in detection area
-// void AgentBasedSensor::update(std::vector<Agent>& agents, float timeStep, sf::Time simulationTime, std::string datetime) {
-void AgentBasedSensor::update(std::vector<Agent>& agents, float timeStep, std::chrono::system_clock::time_point timestamp) {
+// void AgentBasedSensor::update(std::vector<Agent>& agents, float timeStep, sim::Time simulationTime, std::string datetime) {
+void AgentBasedSensor::update(std::vector<Agent>& agents, const SimulationClock& clock) {
 
-    // Update current timestamp
-    this->timestamp = timestamp;
+    // Update current timestamp, the time of the agent states
+    this->timestamp = clock.getPreviousTimestamp();
 
     // Clear the data storage
     agentData.clear();
 
-    // Update the time since the last update
-    timeSinceLastUpdate += timeStep;
-
     // Update the estimated velocities at the specified frame rate
     // if (timeSinceLastUpdate >= 1.0f / frameRate || frameCount != 0) {
-    if (timeSinceLastUpdate >= 1.0f / frameRate) {
+    if (isUpdateDue(clock)) {
 
         // Capture agent data
         captureAgentData(agents);
@@ -63,7 +60,6 @@ void AgentBasedSensor::update(std::vector<Agent>& agents, float timeStep, std::c
         // Reset for next update
         previousPositions = currentPositions;
         currentPositions.clear();
-        timeSinceLastUpdate = 0.0f;
     }
 }
 
@@ -86,10 +82,15 @@ void AgentBasedSensor::captureAgentData(std::vector<Agent>& agents) {
 
             // Estimate and store the velocity of the agent TODO: Only save with velocity
             if (previousPositions.find(agent.agentId) != previousPositions.end()) {
-                sf::Vector2f prevPos = previousPositions[agent.agentId];
+                sim::Vector2f prevPos = previousPositions[agent.agentId];
                 agentDataPoint.estimatedVelocity = (agent.position - previousPositions[agent.agentId]) * frameRate;
             }
 
+            // Update the privacy metrics with the observation
+            if (privacyMetrics) {
+                privacyMetrics->addObservation(timestamp, agentDataPoint.agentId, agentDataPoint.type, agentDataPoint.position, agentDataPoint.estimatedVelocity);
+            }
+
             // Store the agent data
             agentData.emplace_back(agentDataPoint);
             
@@ -0,0 +1,73 @@
+#include "../include/AgentHandle.hpp"
+#include "../include/Checkpoint.hpp"
+
+// Handle to an agent at an index
+AgentHandle AgentHandleTable::create(uint32_t index) {
+
+    // Reuse a released slot if possible
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.push_back(Slot{0, 0, false});
+    }
+
+    slots[slot].index = index;
+    slots[slot].alive = true;
+
+    return AgentHandle{slot, slots[slot].generation};
+}
+
+// Invalidate a handle (stale handles are ignored)
+void AgentHandleTable::release(AgentHandle handle) {
+
+    if (getIndex(handle) < 0) {
+        return;
+    }
+
+    Slot& slot = slots[handle.slot];
+    slot.alive = false;
+    slot.generation++;
+    freeSlots.push_back(handle.slot);
+}
+
+// Update the index of a moved agent
+void AgentHandleTable::relocate(AgentHandle handle, uint32_t index) {
+
+    if (getIndex(handle) >= 0) {
+        slots[handle.slot].index = index;
+    }
+}
+
+// Current index of an agent, -1 if the handle is stale
+int AgentHandleTable::getIndex(AgentHandle handle) const {
+
+    if (handle.slot >= slots.size()) {
+        return -1;
+    }
+
+    const Slot& slot = slots[handle.slot];
+    if (!slot.alive || slot.generation != handle.generation) {
+        return -1;
+    }
+
+    return static_cast<int>(slot.index);
+}
+
+void AgentHandleTable::clear() {
+    slots.clear();
+    freeSlots.clear();
+}
+
+// Checkpoint of the slots, so that handles stay valid after a restore
+void AgentHandleTable::save(CheckpointWriter& writer) const {
+    writer.write(slots);
+    writer.write(freeSlots);
+}
+
+void AgentHandleTable::load(CheckpointReader& reader) {
+    reader.read(slots);
+    reader.read(freeSlots);
+}
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+
 #include "../include/AggregationManager.hpp"
 #include "../include/Utilities.hpp"
 
@@ -5,19 +8,376 @@ AggregationManager::AggregationManager(
     mongocxx::collection& collection,
     const std::string& sensorId,
     std::chrono::system_clock::time_point& timestamp
-) : 
-    collection(collection), 
-    sensorId(sensorId), 
+) :
+    collection(collection),
+    sensorId(sensorId),
     timestamp(timestamp) {
     // Constructor implementation
 }
-// 
+
 AggregationManager::~AggregationManager() {
-    // Destructor implementation
+
+    // Emit the windows still open at the end of the simulation
+    flush();
+
+    // Save the roll-up alongside the leaf stream
+    if (rollupEnabled && !rollupOutput.empty()) {
+        rollupCube.save(rollupOutput);
+    }
+}
+
+// Add the counts of one cell for the current frame to its current pane
+void AggregationManager::ingest(int cellId, const std::unordered_map<std::string, int>& agentTypeCount, int totalAgents, float windowLength, float windowHop,
+                                const std::vector<uint64_t>* agentHashes) {
+
+    using namespace std::chrono;
+
+    if (rollupEnabled) {
+        rollupCube.add(cellId, timestamp, agentTypeCount, totalAgents);
+    }
+
+    if (!enabled) {
+        return;
+    }
+
+    // Use tumbling windows if no valid hop is given, otherwise round the length up to whole hops
+    milliseconds lengthMs(std::max<long long>(1, std::llround(windowLength * 1000.0f)));
+    milliseconds hopMs = (windowHop > 0.0f && windowHop < windowLength)
+        ? milliseconds(std::max<long long>(1, std::llround(windowHop * 1000.0f)))
+        : lengthMs;
+    lengthMs = ((lengthMs + hopMs - milliseconds(1)) / hopMs) * hopMs;
+
+    // Panes are aligned to multiples of the hop so that windows line up across cells
+    milliseconds sinceEpoch = duration_cast<milliseconds>(timestamp.time_since_epoch());
+    system_clock::time_point paneStart(duration_cast<system_clock::duration>((sinceEpoch / hopMs) * hopMs));
+
+    // Start the windows of a new cell and schedule its first window end
+    auto [it, inserted] = aggregatedGridDataBuckets.try_emplace(cellId);
+    CellWindows& cellWindows = it->second;
+    if (inserted) {
+        cellWindows.windowLength = lengthMs;
+        cellWindows.windowHop = hopMs;
+        cellWindows.nextWindowEnd = paneStart + hopMs;
+        schedule(cellId, cellWindows);
+    }
+
+    // Open a new pane when the frame crosses a hop boundary
+    if (cellWindows.panes.empty() || cellWindows.panes.back().aggregationStartTime != paneStart) {
+        AggregatedGridDataBucket& pane = cellWindows.panes.emplace_back(acquireBucket(cellId));
+        pane.aggregationStartTime = paneStart;
+        pane.aggregationEndTime = paneStart + cellWindows.windowHop;
+        pane.aggregationDuration = cellWindows.windowHop;
+
+        // Share the pane sketch of all cells with the same pane
+        if (approximate) {
+            auto [sketchIt, sketchInserted] = paneSketches.try_emplace(getPaneKey(pane));
+            if (sketchInserted) {
+                if (sketchPool.empty()) {
+                    sketchIt->second.sketch = CountMinSketch(sketchEpsilon, sketchDelta);
+                } else {
+                    sketchIt->second.sketch = std::move(sketchPool.back());
+                    sketchPool.pop_back();
+                }
+            }
+            sketchIt->second.numPanes++;
+        }
+    }
+
+    AggregatedGridDataBucket& pane = cellWindows.panes.back();
+    if (!approximate) {
+        pane.add(agentTypeCount, totalAgents);
+        return;
+    }
+
+    // Approximate mode: counts go into the pane sketch shared by all cells, agents into the pane's HyperLogLog
+    CountMinSketch& sketch = getPaneSketch(pane);
+    for (const auto& [agentType, count] : agentTypeCount) {
+        int typeIndex = getAgentTypeIndex(agentType);
+        if (typeIndex < 0) continue;
+        sketch.add(makeSketchKey(cellId, typeIndex), count);
+        pane.agentTypeMask |= uint64_t{1} << typeIndex;
+    }
+    sketch.add(makeSketchKey(cellId, totalIndex), totalAgents);
+    pane.frameCount++;
+
+    if (agentHashes) {
+        for (uint64_t agentHash : *agentHashes) {
+            pane.distinctAgents.add(agentHash);
+        }
+    }
+}
+
+// Close and emit the windows of all cells due since the last update
+void AggregationManager::update() {
+
+    if (!enabled) {
+        return;
+    }
+
+    // Advance the wheel to the current tick, collecting the due entries of every passed slot
+    int64_t nowTick = std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count() / wheelTickMs;
+    if (wheelTick < 0) {
+        wheelTick = nowTick - 1;
+    }
+
+    int64_t steps = std::min<int64_t>(nowTick - wheelTick, static_cast<int64_t>(wheelSize));
+    for (int64_t step = 1; step <= steps; ++step) {
+        std::vector<WheelEntry>& slot = wheel[static_cast<size_t>(wheelTick + step) % wheelSize];
+        for (size_t i = 0; i < slot.size();) {
+            if (slot[i].dueTick <= nowTick) {
+                dueEntries.push_back(slot[i]);
+                slot[i] = slot.back();
+                slot.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+    wheelTick = std::max(wheelTick, nowTick);
+
+    // Close the due windows, then reschedule the cell or forget it once it has no open panes
+    std::vector<bsoncxx::document::value> documents;
+    for (const WheelEntry& entry : dueEntries) {
+        auto it = aggregatedGridDataBuckets.find(entry.cellId);
+        if (it == aggregatedGridDataBuckets.end()) continue;
+
+        closeWindows(it->second, timestamp, documents);
+        if (it->second.panes.empty()) {
+            aggregatedGridDataBuckets.erase(it);
+        } else {
+            schedule(entry.cellId, it->second);
+        }
+    }
+    dueEntries.clear();
+
+    postDocuments(documents);
+}
+
+// Emit all open windows, also the partial ones
+void AggregationManager::flush() {
+
+    if (!enabled) {
+        return;
+    }
+
+    std::vector<bsoncxx::document::value> documents;
+    for (auto& [cellId, cellWindows] : aggregatedGridDataBuckets) {
+        closeWindows(cellWindows, std::chrono::system_clock::time_point::max(), documents);
+    }
+    aggregatedGridDataBuckets.clear();
+    for (std::vector<WheelEntry>& slot : wheel) {
+        slot.clear();
+    }
+
+    postDocuments(documents);
+}
+
+// Sum the panes of every window of a cell ending before `until` and drop panes no longer needed
+void AggregationManager::closeWindows(CellWindows& cellWindows, std::chrono::system_clock::time_point until, std::vector<bsoncxx::document::value>& documents) {
+
+    while (!cellWindows.panes.empty() && cellWindows.nextWindowEnd <= until) {
+
+        // Skip empty windows after a gap in the cell's data
+        const AggregatedGridDataBucket& firstPane = cellWindows.panes.front();
+        if (firstPane.aggregationStartTime >= cellWindows.nextWindowEnd) {
+            cellWindows.nextWindowEnd = firstPane.aggregationStartTime + cellWindows.windowHop;
+            continue;
+        }
+
+        // Sum the panes inside [nextWindowEnd - windowLength, nextWindowEnd)
+        AggregatedGridDataBucket& window = windowBucket;
+        window.reset();
+        window.cellId = firstPane.cellId;
+        window.aggregationStartTime = cellWindows.nextWindowEnd - cellWindows.windowLength;
+        window.aggregationEndTime = cellWindows.nextWindowEnd;
+        window.aggregationDuration = cellWindows.windowLength;
+
+        for (const AggregatedGridDataBucket& pane : cellWindows.panes) {
+            if (pane.aggregationStartTime >= window.aggregationEndTime) break;
+            if (pane.aggregationStartTime >= window.aggregationStartTime) {
+                window.merge(pane);
+                if (approximate) addPaneEstimates(window, pane);
+            }
+        }
+
+        if (window.frameCount > 0) {
+            window.flush(sensorId, documents);
+        }
+
+        // Advance by one hop and drop the panes left behind by the next window
+        cellWindows.nextWindowEnd += cellWindows.windowHop;
+        while (!cellWindows.panes.empty() &&
+               cellWindows.panes.front().aggregationEndTime <= cellWindows.nextWindowEnd - cellWindows.windowLength) {
+            dropFrontPane(cellWindows);
+        }
+    }
+}
+
+// Return the oldest pane of a cell to the pool, releasing its pane sketch
+void AggregationManager::dropFrontPane(CellWindows& cellWindows) {
+
+    AggregatedGridDataBucket& pane = cellWindows.panes.front();
+
+    if (approximate) {
+        auto it = paneSketches.find(getPaneKey(pane));
+        if (it != paneSketches.end() && --it->second.numPanes == 0) {
+            it->second.sketch.clear();
+            sketchPool.push_back(std::move(it->second.sketch));
+            paneSketches.erase(it);
+        }
+    }
+
+    releaseBucket(std::move(pane));
+    cellWindows.panes.pop_front();
+}
+
+// Put the next window end of a cell on the wheel (due at the first tick at or after it)
+void AggregationManager::schedule(int cellId, const CellWindows& cellWindows) {
+
+    int64_t endMs = std::chrono::duration_cast<std::chrono::milliseconds>(cellWindows.nextWindowEnd.time_since_epoch()).count();
+    int64_t dueTick = (endMs + wheelTickMs - 1) / wheelTickMs;
+    wheel[static_cast<size_t>(dueTick) % wheelSize].push_back({cellId, dueTick});
+}
+
+// Bulk insert the closed windows into the sensor collection
+void AggregationManager::postDocuments(std::vector<bsoncxx::document::value>& documents) {
+
+    if (documents.empty()) {
+        return;
+    }
+
+    // Hand the batch to the writer thread if there is one
+    if (writer) {
+        writer->submit(std::move(documents));
+        documents.clear();
+        return;
+    }
+
+    try {
+        collection.insert_many(documents);
+    } catch (const mongocxx::exception& e) {
+        // Handle errors
+        std::cerr << "Error inserting aggregated data: " << e.what() << std::endl;
+    }
+}
+
+// Take a pane from the pool (or a new one)
+AggregationManager::AggregatedGridDataBucket AggregationManager::acquireBucket(int cellId) {
+
+    if (bucketPool.empty()) {
+        AggregatedGridDataBucket bucket(cellId);
+        if (approximate) {
+            bucket.distinctAgents = HyperLogLog(sketchPrecision);
+        }
+        return bucket;
+    }
+
+    AggregatedGridDataBucket bucket = std::move(bucketPool.back());
+    bucketPool.pop_back();
+    bucket.cellId = cellId;
+
+    return bucket;
+}
+
+// Reset a pane and keep its allocations for reuse
+void AggregationManager::releaseBucket(AggregatedGridDataBucket&& bucket) {
+
+    bucket.reset();
+    bucketPool.push_back(std::move(bucket));
+}
+
+// Count-Min sketch of an open pane
+CountMinSketch& AggregationManager::getPaneSketch(const AggregatedGridDataBucket& pane) {
+    return paneSketches.at(getPaneKey(pane)).sketch;
+}
+
+// Add the estimated counts of a cell in one pane to a window
+void AggregationManager::addPaneEstimates(AggregatedGridDataBucket& window, const AggregatedGridDataBucket& pane) const {
+
+    auto it = paneSketches.find(getPaneKey(pane));
+    if (it == paneSketches.end()) {
+        return;
+    }
+
+    const CountMinSketch& sketch = it->second.sketch;
+    for (uint64_t mask = pane.agentTypeMask; mask; mask &= mask - 1) {
+        int typeIndex = __builtin_ctzll(mask);
+        window.aggregatedData.agentTypeCount[agentTypes[typeIndex]] += sketch.estimate(makeSketchKey(window.cellId, typeIndex));
+    }
+    window.aggregatedData.totalAgents += sketch.estimate(makeSketchKey(window.cellId, totalIndex));
+}
+
+// Pane start and hop in milliseconds
+std::pair<int64_t, int64_t> AggregationManager::getPaneKey(const AggregatedGridDataBucket& pane) {
+    using namespace std::chrono;
+    return {duration_cast<milliseconds>(pane.aggregationStartTime.time_since_epoch()).count(),
+            duration_cast<milliseconds>(pane.aggregationDuration).count()};
+}
+
+// Index of an agent type for the sketch keys and type masks, -1 if there are more than 64
+int AggregationManager::getAgentTypeIndex(const std::string& agentType) {
+
+    auto it = agentTypeIndices.find(agentType);
+    if (it == agentTypeIndices.end()) {
+        if (agentTypes.size() >= 64) {
+            ERROR_MSG("Error: More than 64 agent types for the approximate aggregation, ignoring " << agentType);
+            return -1;
+        }
+        it = agentTypeIndices.emplace(agentType, static_cast<int>(agentTypes.size())).first;
+        agentTypes.push_back(agentType);
+    }
+
+    return it->second;
+}
+
+// Start the writer thread for the closed windows
+void AggregationManager::startAsyncWriter(const std::string& uri, const std::string& databaseName, const std::string& collectionName) {
+    writer = std::make_unique<AsyncWriter>(uri, databaseName, collectionName);
+}
+
+// Append the window document of a bucket to a bulk insert
+void AggregationManager::AggregatedGridDataBucket::flush(const std::string& sensorId, std::vector<bsoncxx::document::value>& documents) const {
+
+    bsoncxx::builder::stream::document document{};
+
+    document << "timestamp" << bsoncxx::types::b_date{aggregationEndTime}
+             << "sensor_id" << sensorId
+             << "data_type" << "aggregated adaptive grid data"
+             << "cell_id" << cellId
+             << "window_start" << bsoncxx::types::b_date{aggregationStartTime}
+             << "window_end" << bsoncxx::types::b_date{aggregationEndTime}
+             << "window_length" << std::chrono::duration<double>(aggregationDuration).count()
+             << "frame_count" << frameCount;
+
+    // Open an array for the agent type count
+    auto agentTypeBuilder = document << "agent_type_count" << bsoncxx::builder::stream::open_array;
+
+    for (const auto& [agentType, count] : aggregatedData.agentTypeCount) {
+        agentTypeBuilder
+            << bsoncxx::builder::stream::open_document
+            << "type" << agentType
+            << "count" << count
+            << bsoncxx::builder::stream::close_document;
+    }
+
+    // Close the array
+    agentTypeBuilder << bsoncxx::builder::stream::close_array;
+
+    // Summed and mean agent counts over the frames of the window
+    document << "total_agents" << aggregatedData.totalAgents
+             << "mean_agents" << static_cast<double>(aggregatedData.totalAgents) / frameCount;
+
+    // Approximate mode: distinct agents of the window, counts above are sketch estimates
+    if (!distinctAgents.empty()) {
+        document << "distinct_agents" << static_cast<int64_t>(std::llround(distinctAgents.estimate()))
+                 << "approximate" << true;
+    }
+
+    documents.push_back(document << bsoncxx::builder::stream::finalize);
 }
 
 void AggregationManager::postDataTest() {
-        
+
     bsoncxx::builder::stream::document document{};
     document << "timestamp" << bsoncxx::types::b_date{timestamp};
 
@@ -27,4 +387,4 @@ void AggregationManager::postDataTest() {
         // Handle errors
         std::cerr << "Error inserting metadata: " << e.what() << std::endl;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,73 @@
+#include <iostream>
+
+#include "../include/AsyncWriter.hpp"
+
+AsyncWriter::AsyncWriter(const std::string& uri, const std::string& databaseName, const std::string& collectionName)
+    : uri(uri), databaseName(databaseName), collectionName(collectionName) {
+
+    worker = std::thread(&AsyncWriter::run, this);
+}
+
+AsyncWriter::~AsyncWriter() {
+    stop();
+}
+
+// Queue a batch of documents for a bulk insert
+void AsyncWriter::submit(std::vector<bsoncxx::document::value>&& documents) {
+
+    if (documents.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        batches.push_back(std::move(documents));
+    }
+    queueCond.notify_one();
+}
+
+// Insert all queued batches and stop the writer thread
+void AsyncWriter::stop() {
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopped) {
+            return;
+        }
+        stopped = true;
+    }
+    queueCond.notify_one();
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+// Writer thread: take all queued batches at once and insert them outside of the lock
+void AsyncWriter::run() {
+
+    mongocxx::client client{mongocxx::uri{uri}};
+    mongocxx::collection collection = client[databaseName][collectionName];
+
+    std::deque<std::vector<bsoncxx::document::value>> pending;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCond.wait(lock, [this] { return stopped || !batches.empty(); });
+            if (batches.empty() && stopped) {
+                return;
+            }
+            pending.swap(batches);
+        }
+
+        for (auto& documents : pending) {
+            try {
+                collection.insert_many(documents);
+            } catch (const mongocxx::exception& e) {
+                // Handle errors
+                std::cerr << "Error inserting aggregated data: " << e.what() << std::endl;
+            }
+        }
+        pending.clear();
+    }
+}
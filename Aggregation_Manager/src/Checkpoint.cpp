@@ -0,0 +1,80 @@
+#include <iostream>
+
+#include "../include/Checkpoint.hpp"
+
+// Open a file and write the header
+CheckpointWriter::CheckpointWriter(const std::string& path) : fileStream(path, std::ios::binary), file(fileStream) {
+
+    if (!file) {
+        ERROR_MSG("Error: Could not open checkpoint output " << path);
+        return;
+    }
+
+    file.write("SCKP", 4);
+    write(Checkpoint::version);
+}
+
+void CheckpointWriter::write(const std::string& value) {
+
+    write(static_cast<uint64_t>(value.size()));
+    file.write(value.data(), value.size());
+}
+
+// Open a file and check the header
+CheckpointReader::CheckpointReader(const std::string& path) : fileStream(path, std::ios::binary | std::ios::ate), file(fileStream) {
+
+    if (!file) {
+        ERROR_MSG("Error: Could not open checkpoint " << path);
+        return;
+    }
+    fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    // Magic and a version this build can read
+    char magic[4];
+    if (!file.read(magic, 4) || std::string(magic, 4) != "SCKP") {
+        ERROR_MSG("Error: " << path << " is not a checkpoint file");
+        return;
+    }
+    read(version);
+    if (!file || version == 0 || version > Checkpoint::version) {
+        ERROR_MSG("Error: Checkpoint " << path << " has version " << version << ", supported up to " << Checkpoint::version);
+        return;
+    }
+
+    valid = true;
+}
+
+// Read from a stream without a header, in the current format
+CheckpointReader::CheckpointReader(std::istream& stream) : file(stream), version(Checkpoint::version) {
+
+    // Remaining bytes bound the length prefixes
+    std::streampos start = file.tellg();
+    file.seekg(0, std::ios::end);
+    fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(start);
+
+    valid = static_cast<bool>(file);
+}
+
+void CheckpointReader::read(std::string& value) {
+
+    uint64_t size = readSize();
+    value.resize(size);
+    file.read(value.data(), size);
+}
+
+// Length prefix, 0 (and a failed stream) if it exceeds the remaining bytes
+uint64_t CheckpointReader::readSize() {
+
+    uint64_t size = 0;
+    read(size);
+
+    uint64_t position = file ? static_cast<uint64_t>(file.tellg()) : fileSize;
+    if (!file || size > fileSize - position) {
+        file.setstate(std::ios::failbit);
+        return 0;
+    }
+
+    return size;
+}
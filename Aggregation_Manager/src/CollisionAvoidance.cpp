@@ -9,8 +9,8 @@ bool predictCollisionAgents_v1(Agent& agent1, Agent& agent2) {
     const float maxLookahead = 2.0f; // Maximum lookahead time
 
     for (float t = 0; t <= maxLookahead; t += lookaheadStep) {
-        sf::Vector2f futurePos1 = agent1.getFuturePositionAtTime(t);
-        sf::Vector2f futurePos2 = agent2.getFuturePositionAtTime(t);
+        sim::Vector2f futurePos1 = agent1.getFuturePositionAtTime(t);
+        sim::Vector2f futurePos2 = agent2.getFuturePositionAtTime(t);
 
         // Check if the future positions (including buffer radius) intersect
         float dx = futurePos1.x - futurePos2.x;
@@ -18,8 +18,8 @@ bool predictCollisionAgents_v1(Agent& agent1, Agent& agent2) {
         float distance = std::sqrt(dx * dx + dy * dy);
 
         if (distance < agent1.bufferZoneRadius + agent2.bufferZoneRadius) {
-            agent1.bufferZoneColor = sf::Color::Red;
-            agent2.bufferZoneColor = sf::Color::Red;
+            agent1.bufferZoneColor = sim::Color::Red;
+            agent2.bufferZoneColor = sim::Color::Red;
             agent1.collisionPredicted = true;
             agent2.collisionPredicted = true;
 
@@ -48,8 +48,8 @@ bool predictCollisionAgents_v2(Agent& agent1, Agent& agent2) {
     const float maxLookahead = agent1.lookAheadTime; // Maximum lookahead time
 
     for (float t = 0; t <= maxLookahead; t += lookaheadStep) {
-        sf::Vector2f futurePos1 = agent1.getFuturePositionAtTime(t);
-        sf::Vector2f futurePos2 = agent2.getFuturePositionAtTime(t);
+        sim::Vector2f futurePos1 = agent1.getFuturePositionAtTime(t);
+        sim::Vector2f futurePos2 = agent2.getFuturePositionAtTime(t);
         
         // Check if the future positions (including buffer radius) intersect
         float dx = futurePos1.x - futurePos2.x;
@@ -66,8 +66,8 @@ bool predictCollisionAgents_v2(Agent& agent1, Agent& agent2) {
         // }
 
         if (distance < combinedRadius) {
-            agent1.bufferZoneColor = sf::Color::Red;
-            agent2.bufferZoneColor = sf::Color::Red;
+            agent1.bufferZoneColor = sim::Color::Red;
+            agent2.bufferZoneColor = sim::Color::Red;
             agent1.collisionPredicted = true;
             agent2.collisionPredicted = true;
 
@@ -98,8 +98,8 @@ bool predictCollisionAgents(Agent& agent1, Agent& agent2) {
 
     // Check for collision between two agents
     for (float t = 0; t <= maxLookahead; t += lookaheadStep) {
-        sf::Vector2f futurePos1 = agent1.getFuturePositionAtTime(t);
-        sf::Vector2f futurePos2 = agent2.getFuturePositionAtTime(t);
+        sim::Vector2f futurePos1 = agent1.getFuturePositionAtTime(t);
+        sim::Vector2f futurePos2 = agent2.getFuturePositionAtTime(t);
 
         // Check if the future positions (including buffer radius) intersect
         float dx = futurePos1.x - futurePos2.x;
@@ -107,8 +107,8 @@ bool predictCollisionAgents(Agent& agent1, Agent& agent2) {
         float distance = std::sqrt(dx * dx + dy * dy);
 
         if (distance < agent1.bufferZoneRadius + agent2.bufferZoneRadius) {
-            agent1.bufferZoneColor = sf::Color::Red;
-            agent2.bufferZoneColor = sf::Color::Red;
+            agent1.bufferZoneColor = sim::Color::Red;
+            agent2.bufferZoneColor = sim::Color::Red;
             agent1.collisionPredicted = true;
             agent2.collisionPredicted = true;
 
@@ -140,56 +140,26 @@ bool predictCollisionAgents(Agent& agent1, Agent& agent2) {
     return false; // No collision detected in the lookahead time frame
 }
 
-// Check for future collision between an agent and an obstacle
-bool predictCollisionObstacle(Agent& agent, const std::vector<Obstacle>& obstacles) {
+// Check for future collision between an agent and the obstacles (its buffer zone swept along its path within the look-ahead time)
+bool predictCollisionObstacle(Agent& agent, const ObstacleIndex& obstacles) {
 
-    const float lookaheadStep = 0.2f; // Time step for predictions
-    const float maxLookahead = 2.0f; // Maximum lookahead time
-
-    for (float t = 0; t <= maxLookahead; t += lookaheadStep) {
-        sf::Vector2f futurePos = agent.getFuturePositionAtTime(t);
-
-        // Calculate agent's future bounds (including buffer radius)
-        // Note: SFML 2.6.2 and prior
-        // sf::FloatRect agentBounds(
-        //     futurePos.x - agent.bufferZoneRadius,
-        //     futurePos.y - agent.bufferZoneRadius,
-        //     2 * agent.bufferZoneRadius,
-        //     2 * agent.bufferZoneRadius
-        // );
-        sf::FloatRect agentBounds(
-            {
-                futurePos.x - agent.bufferZoneRadius,
-                futurePos.y - agent.bufferZoneRadius
-            },
-            {
-                2 * agent.bufferZoneRadius,
-                2 * agent.bufferZoneRadius
-            }
-        );
-
-        for (const Obstacle& obstacle : obstacles) {
-            std::cout << "Obstacle: " << obstacle.getBounds().position.x << ", " << obstacle.getBounds().position.y << std::endl;
-            std:: cout << "Agent: " << agentBounds.position.x << ", " << agentBounds.position.y << std::endl;
-            if (obstacle.getBounds().findIntersection(agentBounds)) {
-                agent.stop(); // or agent->adjustDirection() 
-                return true; // Collision detected
-            }
-        }
+    sim::Vector2f futurePos = agent.getFuturePositionAtTime(agent.lookAheadTime);
 
-        // Note: SFML 2.6.2 and prior
-        // for (const Obstacle& obstacle : obstacles) {
-        //     std::cout << "Obstacle: " << obstacle.getBounds().top << ", " << obstacle.getBounds().left << std::endl; // Error: top=y, left=x
-        //     std:: cout << "Agent: " << agentBounds.top << ", " << agentBounds.left << std::endl;
-        //     if (obstacle.getBounds().intersects(agentBounds)) {
-        //         agent.stop(); // or agent->adjustDirection() 
-        //         return true; // Collision detected
-        //     }
-        // }
+    if (obstacles.sweep(agent.position, futurePos, agent.bufferZoneRadius) != ObstacleIndex::noHit) {
+        stopBeforeObstacle(agent);
+        return true; // Collision detected
     }
     return false; // No collision detected in the lookahead time frame
 }
 
+// Mark a predicted obstacle collision and stop the agent
+void stopBeforeObstacle(Agent& agent) {
+
+    agent.bufferZoneColor = sim::Color::Red;
+    agent.collisionPredicted = true;
+    agent.stop(); // or agent->adjustDirection()
+}
+
 // Check for collision between two agents
 bool agentAgentCollision(Agent& agent1, Agent& agent2) {
 
@@ -201,8 +171,8 @@ bool agentAgentCollision(Agent& agent1, Agent& agent2) {
     float combinedRadiusSquared = combinedRadius * combinedRadius;
 
     if(distanceSquared < combinedRadiusSquared) {
-        agent1.bufferZoneColor = sf::Color::Red;
-        agent2.bufferZoneColor = sf::Color::Red;
+        agent1.bufferZoneColor = sim::Color::Red;
+        agent2.bufferZoneColor = sim::Color::Red;
         agent1.collisionPredicted = true;
         agent2.collisionPredicted = true;
 
@@ -211,65 +181,38 @@ bool agentAgentCollision(Agent& agent1, Agent& agent2) {
     return false; // No collision detected
 }
 
-// Check for collision between two agents
-bool agentAgentsCollision(Agent& agent, std::vector<Agent>& agents) {
+// Check for collision between an agent and its neighbours (buffer zones overlap)
+bool agentAgentsCollision(const Agent& agent, const SpatialQuery& neighbours) {
 
-    // Check for collision with each agent
-    for(Agent& otherAgent : agents) {
+    // Only agents within the largest buffer zone around the agent's buffer zone can overlap it
+    float reach = agent.bufferZoneRadius + neighbours.getMaxAgentRadius();
+    sim::FloatRect area({agent.position.x - reach, agent.position.y - reach}, {2.0f * reach, 2.0f * reach});
 
-        if(&otherAgent == &agent) continue; // Skip self-comparison
+    bool free = neighbours.forEachInRect(area, [&agent](const Agent* otherAgent) {
+
+        if(otherAgent == &agent) return true; // Skip self-comparison
 
         // Calculate distance between agents
-        float dx = agent.position.x - otherAgent.position.x;
-        float dy = agent.position.y - otherAgent.position.y;
+        float dx = agent.position.x - otherAgent->position.x;
+        float dy = agent.position.y - otherAgent->position.y;
         float distanceSquared = dx * dx + dy * dy;
 
         // Calculate combined radius
-        float combinedRadius = agent.bufferZoneRadius + otherAgent.bufferZoneRadius;
-        float combinedRadiusSquared = combinedRadius * combinedRadius;
+        float combinedRadius = agent.bufferZoneRadius + otherAgent->bufferZoneRadius;
 
         // Collision occurs if the distance is less than the combined radius
-        if(distanceSquared < combinedRadiusSquared) {
-            
-            return true; // Collision detected
-        }
-    }
-    return false; // No collision detected
+        return distanceSquared >= combinedRadius * combinedRadius;
+    });
+    return !free; // Collision detected if the search stopped early
 }
 
 // Check for collision between an agent and an obstacle
-bool agentObstaclesCollision(Agent& agent, const std::vector<Obstacle>& obstacles) {
-
-    // Extract circle information from the Agent
-    sf::Vector2f circleCenter = agent.position;
-    float circleRadius = agent.bufferZoneRadius;
+bool agentObstaclesCollision(Agent& agent, const ObstacleIndex& obstacles) {
 
-    // Check for collision with each obstacle
-    for(const Obstacle& obstacle : obstacles) {
-
-        // Extract rectangle information from the Obstacle
-        sf::FloatRect rect = obstacle.getBounds();
-    
-        // Find the closest point on the rectangle to the circle's center
-        // Note: SFML 2.6.2 and prior
-        // float closestX = std::max(rect.left, std::min(circleCenter.x, rect.left + rect.width));
-        // float closestY = std::max(rect.top, std::min(circleCenter.y, rect.top + rect.height));
-        float closestX = std::max(rect.position.x, std::min(circleCenter.x, rect.position.x + rect.size.x));
-        float closestY = std::max(rect.position.y, std::min(circleCenter.y, rect.position.y + rect.size.y));
-
-        // Calculate the distance between the circle's center and the closest point
-        float distanceX = circleCenter.x - closestX;
-        float distanceY = circleCenter.y - closestY;
-        float distanceSquared = distanceX * distanceX + distanceY * distanceY;
-
-        // Collision occurs if the distance is less than or equal to the circle's radius
-        if(distanceSquared <= circleRadius * circleRadius) {
-            agent.bufferZoneColor = sf::Color::Red;
-            agent.collisionPredicted = true;
-            agent.stop(); // Stop the agent
-
-            return true; // Collision detected
-        }
+    // Collision occurs if the buffer zone overlaps an obstacle
+    if(obstacles.overlaps(agent.position, agent.bufferZoneRadius)) {
+        stopBeforeObstacle(agent);
+        return true; // Collision detected
     }
     return false; // No collision detected
 }
@@ -278,8 +221,8 @@ bool agentObstaclesCollision(Agent& agent, const std::vector<Obstacle>& obstacle
 bool collisionPossible(Agent& agent1, Agent& agent2) {
 
     // Calculate relative velocity and position
-    sf::Vector2f relativeVector = agent2.velocity - agent1.velocity;
-    sf::Vector2f relativePosition = agent2.position - agent1.position;
+    sim::Vector2f relativeVector = agent2.velocity - agent1.velocity;
+    sim::Vector2f relativePosition = agent2.position - agent1.position;
 
     // Check if agents are moving towards each other (dot product)
     if (relativeVector.x * relativePosition.x + 
@@ -1,21 +1,48 @@
 #include <vector>
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 
 #include "../include/CollisionGrid.hpp"
 #include "../include/CollisionAvoidance.hpp" // Include the new header
 
 // Constructor
-Grid::Grid(float cellSize, sf::FloatRect detectionArea)
+Grid::Grid(float cellSize, sim::FloatRect detectionArea)
     : cellSize(cellSize), detectionArea(detectionArea), cells(0, Vector2iHash{}) {
 
         this->cellSize = cellSize;
+
+        // Number of cells covering the detection area
+        width = cellSize > 0.0f ? static_cast<int>(std::ceil(detectionArea.size.x / cellSize)) : 0;
+        height = cellSize > 0.0f ? static_cast<int>(std::ceil(detectionArea.size.y / cellSize)) : 0;
 }
 
 // Add agent to the grid
-sf::Vector2i Grid::addAgent(Agent* agent) {
+sim::Vector2i Grid::addAgent(Agent* agent) {
 
-    sf::Vector2i cellIndex = getGridCellIndex(agent->position);
+    sim::Vector2i cellIndex = getGridCellIndex(agent->position);
     cells[cellIndex].agents.push_back(agent);
+    maxAgentRadius = std::max({maxAgentRadius, agent->bodyRadius, agent->bufferZoneRadius});
+
+    return cellIndex;
+}
+
+// Add a ghost agent to the grid (only checked against the grid's own agents)
+sim::Vector2i Grid::addGhost(Agent* ghost) {
+
+    sim::Vector2i cellIndex = getGridCellIndex(ghost->position);
+    cells[cellIndex].ghosts.push_back(ghost);
+    maxAgentRadius = std::max({maxAgentRadius, ghost->bodyRadius, ghost->bufferZoneRadius});
+
+    return cellIndex;
+}
+
+// Add an agent that is not moved this frame (not checked for collisions, only visible to queries)
+sim::Vector2i Grid::addStatic(Agent* agent) {
+
+    sim::Vector2i cellIndex = getGridCellIndex(agent->position);
+    cells[cellIndex].statics.push_back(agent);
+    maxAgentRadius = std::max({maxAgentRadius, agent->bodyRadius, agent->bufferZoneRadius});
 
     return cellIndex;
 }
@@ -23,6 +50,7 @@ sf::Vector2i Grid::addAgent(Agent* agent) {
 // Clear the grid
 void Grid::clear() {
     cells.clear();
+    maxAgentRadius = 0.0f;
 }
 
 // Calculate agent density in each cell
@@ -57,12 +85,13 @@ void Grid::checkCollisions() {
             }   
         }
 
-        // Check collisions with agents in adjacent cells
-        for (const sf::Vector2i& adjacentIndex : getAdjacentCellIndices(cellIndex)) {
+        // Check collisions with agents in the forward half of the adjacent cells, so each pair is checked once
+        for (const sim::Vector2i& adjacentIndex : getForwardCellIndices(cellIndex)) {
 
-            if (cells.count(adjacentIndex) > 0) { // Check if the adjacent cell exists
+            auto adjacent = cells.find(adjacentIndex);
+            if (adjacent != cells.end()) { // Check if the adjacent cell exists
 
-                const GridCell& adjacentCell = cells[adjacentIndex];
+                const GridCell& adjacentCell = adjacent->second;
                 for (Agent* agent1 : cell.agents) {
 
                     for (Agent* agent2 : adjacentCell.agents) {
@@ -76,21 +105,49 @@ void Grid::checkCollisions() {
                 }
             }
         }
+
+        // Check collisions with ghosts in the same and adjacent cells
+        if (cell.agents.empty()) continue;
+        checkGhostCollisions(cell, cell);
+        for (const sim::Vector2i& adjacentIndex : getAdjacentCellIndices(cellIndex)) {
+
+            auto adjacentCell = cells.find(adjacentIndex);
+            if (adjacentCell != cells.end()) {
+                checkGhostCollisions(cell, adjacentCell->second);
+            }
+        }
+    }
+}
+
+// Check the agents of a cell against the ghosts of a cell
+void Grid::checkGhostCollisions(const GridCell& cell, const GridCell& ghostCell) {
+
+    for (Agent* agent : cell.agents) {
+
+        for (Agent* ghost : ghostCell.ghosts) {
+
+            if (collisionPossible(*agent, *ghost)) {
+
+                // Same argument order as where the ghost is owned (smaller id first), so both sides decide alike
+                bool agentFirst = agent->agentId < ghost->agentId;
+                predictCollisionAgents(agentFirst ? *agent : *ghost, agentFirst ? *ghost : *agent);
+            }
+        }
     }
 }
 
 // Get cell index based on position
-sf::Vector2i Grid::getGridCellIndex(const sf::Vector2f& position) {
+sim::Vector2i Grid::getGridCellIndex(const sim::Vector2f& position) const {
 
     int x = static_cast<int>((position.x - detectionArea.position.x) / cellSize); 
     int y = static_cast<int>((position.y - detectionArea.position.y) / cellSize);
 
-    return sf::Vector2i(x, y);
+    return sim::Vector2i(x, y);
 }
 
 // Helper function to get adjacent cell indices (including diagonals)
-std::vector<sf::Vector2i> Grid::getAdjacentCellIndices(const sf::Vector2i& cellIndex) const {
-    std::vector<sf::Vector2i> adjacentIndices;
+std::vector<sim::Vector2i> Grid::getAdjacentCellIndices(const sim::Vector2i& cellIndex) const {
+    std::vector<sim::Vector2i> adjacentIndices;
     for (int dx = -1; dx <= 1; ++dx) {
         for (int dy = -1; dy <= 1; ++dy) {
             if (dx == 0 && dy == 0) continue; // Skip the current cell
@@ -100,9 +157,19 @@ std::vector<sf::Vector2i> Grid::getAdjacentCellIndices(const sf::Vector2i& cellI
 
             // Check if the adjacent cell is within the grid boundaries
             if (newX >= 0 && newX < width && newY >= 0 && newY < height) {
-                adjacentIndices.push_back(sf::Vector2i(newX, newY));
+                adjacentIndices.push_back(sim::Vector2i(newX, newY));
             }
         }
     }
     return adjacentIndices;
 }
+
+// Adjacent cells after the cell in row-major order (right, and the three below), half of the neighbourhood
+std::array<sim::Vector2i, 4> Grid::getForwardCellIndices(const sim::Vector2i& cellIndex) const {
+    return {
+        sim::Vector2i(cellIndex.x + 1, cellIndex.y),
+        sim::Vector2i(cellIndex.x - 1, cellIndex.y + 1),
+        sim::Vector2i(cellIndex.x, cellIndex.y + 1),
+        sim::Vector2i(cellIndex.x + 1, cellIndex.y + 1)
+    };
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <sstream>
+
+#include "../include/Coordinator.hpp"
+#include "../include/Checkpoint.hpp"
+#include "../include/SimTypes.hpp"
+#include "../include/Logging.hpp"
+
+// Coordinator constructor
+Coordinator::Coordinator(const YAML::Node& config)
+    : settings(Distributed::Settings::load(config)) {
+}
+
+// Accept one connection per rank, ordered by the rank each one announces
+bool Coordinator::acceptRanks() {
+
+    Socket listener = Socket::listen(settings.coordinator);
+    if (!listener.valid()) {
+        return false;
+    }
+
+    ranks.clear();
+    ranks.resize(settings.ranks);
+    for (int connected = 0; connected < settings.ranks;) {
+
+        Socket connection = listener.accept();
+        uint32_t type = 0;
+        std::string payload;
+        if (!connection.valid() || !connection.receiveMessage(type, payload) || type != Distributed::Hello) {
+            continue;
+        }
+
+        std::istringstream message(payload);
+        CheckpointReader reader(message);
+        int32_t rank = -1;
+        reader.read(rank);
+        if (!reader.good() || rank < 0 || rank >= settings.ranks || ranks[rank].valid()) {
+            ERROR_MSG("Coordinator: rejected a connection announcing rank " << rank);
+            continue;
+        }
+
+        ranks[rank] = std::move(connection);
+        ++connected;
+        DEBUG_MSG("Coordinator: rank " << rank << " connected (" << connected << " of " << settings.ranks << ")");
+    }
+    return true;
+}
+
+// Stop the ranks that are still connected
+void Coordinator::stopRanks() {
+
+    for (auto& rank : ranks) {
+        if (rank.valid()) {
+            rank.sendMessage(Distributed::Stop, std::string());
+        }
+    }
+}
+
+// Run the frame barriers until all ranks finished, false if a rank failed
+bool Coordinator::run() {
+
+    if (!acceptRanks()) {
+        return false;
+    }
+    STATS_MSG("Coordinator: " << settings.ranks << " ranks connected");
+
+    sim::Clock wallClock;
+    uint64_t frames = 0;
+    uint64_t totalMigrations = 0;
+    Distributed::FrameStats global;
+
+    while (true) {
+
+        // Barrier: one report of every rank
+        int finished = 0;
+        bool failed = false;
+        global = Distributed::FrameStats();
+        for (int rank = 0; rank < settings.ranks; ++rank) {
+
+            uint32_t type = 0;
+            std::string payload;
+            Distributed::FrameStats stats;
+            if (!ranks[rank].receiveMessage(type, payload)) {
+                ERROR_MSG("Coordinator: lost the connection to rank " << rank);
+                failed = true;
+                continue;
+            }
+            std::istringstream message(payload);
+            CheckpointReader reader(message);
+            reader.read(stats);
+
+            if (type == Distributed::Finished) {
+                ++finished;
+            }
+            global.frame = std::max(global.frame, stats.frame);
+            global.agents += stats.agents;
+            global.arrivals += stats.arrivals;
+            global.departures += stats.departures;
+            global.ghosts += stats.ghosts;
+        }
+
+        // A failed or early finished rank ends the run for all
+        if (failed || (finished > 0 && finished < settings.ranks)) {
+            ERROR_MSG("Coordinator: stopping all ranks at frame " << global.frame);
+            stopRanks();
+            return !failed;
+        }
+        if (finished == settings.ranks) {
+            break;
+        }
+
+        ++frames;
+        totalMigrations += global.departures;
+        if (frames % settings.statsFrames == 0) {
+            STATS_MSG("Coordinator: frame " << global.frame << ", " << global.agents << " agents, " << global.departures << " migrations, " << global.ghosts << " ghosts");
+        }
+
+        for (auto& rank : ranks) {
+            rank.sendMessage(Distributed::Continue, std::string());
+        }
+    }
+
+    STATS_MSG("Coordinator: " << frames << " frames in " << wallClock.getElapsedTime().asSeconds() << " seconds, "
+              << global.agents << " agents, " << totalMigrations << " migrations");
+    return true;
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../include/DistanceField.hpp"
+#include "../include/Logging.hpp"
+
+namespace {
+
+constexpr size_t maxNodes = size_t(1) << 24;
+
+} // namespace
+
+// Rasterize the obstacles: exact signed distances in a band of maxDistance around each obstacle
+void DistanceField::build(const std::vector<Obstacle>& obstacles, float resolution, float maxDistance) {
+
+    values.clear();
+    columns = 0;
+    rows = 0;
+    this->maxDistance = std::max(maxDistance, 0.0f);
+    if (obstacles.empty() || resolution <= 0.0f) {
+        return;
+    }
+
+    // Field area: the obstacles' bounding box extended by the maximum distance
+    sim::Vector2f low(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    sim::Vector2f high(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+    for (const auto& obstacle : obstacles) {
+        sim::FloatRect bounds = obstacle.getBounds();
+        low = {std::min({low.x, bounds.position.x, bounds.position.x + bounds.size.x}), std::min({low.y, bounds.position.y, bounds.position.y + bounds.size.y})};
+        high = {std::max({high.x, bounds.position.x, bounds.position.x + bounds.size.x}), std::max({high.y, bounds.position.y, bounds.position.y + bounds.size.y})};
+    }
+    origin = {low.x - this->maxDistance - resolution, low.y - this->maxDistance - resolution};
+    sim::Vector2f extent(high.x - low.x + 2.0f * (this->maxDistance + resolution), high.y - low.y + 2.0f * (this->maxDistance + resolution));
+
+    // Coarser nodes if the field would get too large
+    float requested = resolution;
+    while (static_cast<size_t>(extent.x / resolution + 2.0f) * static_cast<size_t>(extent.y / resolution + 2.0f) > maxNodes) {
+        resolution *= 2.0f;
+    }
+    if (resolution != requested) {
+        ERROR_MSG("Warning: Distance field resolution of " << requested << " m reduced to " << resolution << " m");
+    }
+    this->resolution = resolution;
+    nodeDiagonal = resolution * std::sqrt(2.0f);
+    columns = static_cast<int>(std::ceil(extent.x / resolution)) + 1;
+    rows = static_cast<int>(std::ceil(extent.y / resolution)) + 1;
+    values.assign(static_cast<size_t>(columns) * rows, this->maxDistance);
+
+    // Nodes within the maximum distance of an obstacle keep the smallest signed distance
+    for (const auto& obstacle : obstacles) {
+
+        sim::FloatRect bounds = obstacle.getBounds();
+        float minX = std::min(bounds.position.x, bounds.position.x + bounds.size.x) - this->maxDistance;
+        float minY = std::min(bounds.position.y, bounds.position.y + bounds.size.y) - this->maxDistance;
+        float maxX = std::max(bounds.position.x, bounds.position.x + bounds.size.x) + this->maxDistance;
+        float maxY = std::max(bounds.position.y, bounds.position.y + bounds.size.y) + this->maxDistance;
+        int x0 = std::clamp(static_cast<int>(std::floor((minX - origin.x) / resolution)), 0, columns - 1);
+        int y0 = std::clamp(static_cast<int>(std::floor((minY - origin.y) / resolution)), 0, rows - 1);
+        int x1 = std::clamp(static_cast<int>(std::ceil((maxX - origin.x) / resolution)), 0, columns - 1);
+        int y1 = std::clamp(static_cast<int>(std::ceil((maxY - origin.y) / resolution)), 0, rows - 1);
+
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                sim::Vector2f node(origin.x + x * resolution, origin.y + y * resolution);
+                float& value = values[static_cast<size_t>(y) * columns + x];
+                value = std::min(value, std::max(obstacle.getSignedDistance(node), -this->maxDistance));
+            }
+        }
+    }
+
+    DEBUG_MSG("Distance field: " << columns << " x " << rows << " nodes of " << resolution << " m for " << obstacles.size() << " obstacles");
+}
+
+// Interpolated signed distance, the maximum distance outside the field
+float DistanceField::getDistance(const sim::Vector2f& point) const {
+
+    sim::Vector2f gradient;
+    return getDistance(point, gradient);
+}
+
+// Interpolated signed distance and its gradient within the cell of the point
+float DistanceField::getDistance(const sim::Vector2f& point, sim::Vector2f& gradient) const {
+
+    gradient = {0.0f, 0.0f};
+    float fx = (point.x - origin.x) / resolution;
+    float fy = (point.y - origin.y) / resolution;
+    if (values.empty() || !(fx >= 0.0f && fy >= 0.0f && fx < columns - 1 && fy < rows - 1)) {
+        return maxDistance;
+    }
+
+    int x = static_cast<int>(fx);
+    int y = static_cast<int>(fy);
+    float tx = fx - x;
+    float ty = fy - y;
+    const float* row0 = &values[static_cast<size_t>(y) * columns + x];
+    const float* row1 = row0 + columns;
+
+    gradient.x = ((1.0f - ty) * (row0[1] - row0[0]) + ty * (row1[1] - row1[0])) / resolution;
+    gradient.y = ((1.0f - tx) * (row1[0] - row0[0]) + tx * (row1[1] - row0[1])) / resolution;
+
+    return (1.0f - ty) * ((1.0f - tx) * row0[0] + tx * row0[1]) + ty * ((1.0f - tx) * row1[0] + tx * row1[1]);
+}
@@ -0,0 +1,41 @@
+#include <algorithm>
+
+#include "../include/Distributed.hpp"
+
+namespace Distributed {
+
+// Endpoints and halo from the distributed section of the configuration
+Settings Settings::load(const YAML::Node& config) {
+
+    Settings settings;
+    const YAML::Node& distributed = config["distributed"];
+
+    if (distributed["ranks"]) {
+        settings.ranks = std::max(distributed["ranks"].as<int>(), 1);
+    }
+    if (distributed["coordinator"]) {
+        settings.coordinator = distributed["coordinator"].as<std::string>();
+    }
+    if (distributed["stats_frames"]) {
+        settings.statsFrames = std::max(distributed["stats_frames"].as<int>(), 1);
+    }
+
+    // Listening endpoint of every rank
+    if (distributed["peers"]) {
+        settings.peers = distributed["peers"].as<std::vector<std::string>>();
+    }
+    for (int rank = static_cast<int>(settings.peers.size()); rank < settings.ranks; ++rank) {
+        settings.peers.push_back("unix:/tmp/simulator_rank" + std::to_string(rank) + ".sock");
+    }
+
+    // The halo covers the collision neighbourhood unless set
+    if (distributed["halo"]) {
+        settings.halo = distributed["halo"].as<float>();
+    } else {
+        settings.halo = config["collision"]["grid"]["cell_size"].as<float>();
+    }
+
+    return settings;
+}
+
+} // namespace Distributed
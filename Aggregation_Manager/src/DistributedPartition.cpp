@@ -0,0 +1,203 @@
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "../include/DistributedPartition.hpp"
+#include "../include/Checkpoint.hpp"
+
+// Connect to the coordinator and the neighbouring ranks (throws if a connection fails)
+DistributedPartition::DistributedPartition(const Distributed::Settings& settings, int rank, float simulationWidth)
+    : rank(rank), ranks(settings.ranks), halo(settings.halo) {
+
+    if (rank < 0 || rank >= ranks) {
+        throw std::runtime_error("Rank " + std::to_string(rank) + " outside of 0.." + std::to_string(ranks - 1));
+    }
+
+    // Strip of equal width
+    float stripWidth = simulationWidth / ranks;
+    stripBegin = rank * stripWidth;
+    stripEnd = rank + 1 == ranks ? simulationWidth : (rank + 1) * stripWidth;
+    if (halo > stripWidth) {
+        ERROR_MSG("Warning: Distributed halo of " << halo << " m exceeds the strip width, reduced to " << stripWidth << " m");
+        halo = stripWidth;
+    }
+
+    // Listen for the left neighbour before connecting to the right one, so that the chain cannot block
+    Socket listener;
+    if (rank > 0) {
+        listener = Socket::listen(settings.peers[rank]);
+        if (!listener.valid()) {
+            throw std::runtime_error("Could not listen on " + settings.peers[rank]);
+        }
+    }
+
+    std::ostringstream hello;
+    CheckpointWriter helloWriter(hello);
+    helloWriter.write(static_cast<int32_t>(rank));
+
+    if (rank + 1 < ranks) {
+        Neighbour right{rank + 1, false, Socket::connect(settings.peers[rank + 1]), {}, {}, {}};
+        if (!right.socket.valid() || !right.socket.sendMessage(Distributed::Hello, hello.str())) {
+            throw std::runtime_error("Could not connect to rank " + std::to_string(rank + 1) + " at " + settings.peers[rank + 1]);
+        }
+        neighbours.push_back(std::move(right));
+    }
+    if (rank > 0) {
+        Neighbour left{rank - 1, true, listener.accept(), {}, {}, {}};
+        uint32_t type = 0;
+        std::string payload;
+        if (!left.socket.valid() || !left.socket.receiveMessage(type, payload) || type != Distributed::Hello) {
+            throw std::runtime_error("Rank " + std::to_string(rank - 1) + " did not connect");
+        }
+        neighbours.push_back(std::move(left));
+    }
+
+    // Register at the coordinator
+    coordinator = Socket::connect(settings.coordinator);
+    if (!coordinator.valid() || !coordinator.sendMessage(Distributed::Hello, hello.str())) {
+        throw std::runtime_error("Could not connect to the coordinator at " + settings.coordinator);
+    }
+
+    DEBUG_MSG("Distributed: rank " << rank << " of " << ranks << " owns x in [" << stripBegin << ", " << stripEnd << ") with a " << halo << " m halo");
+}
+
+// Whether a position lies in the strip (the outer strips extend beyond the area)
+bool DistributedPartition::owns(const sim::Vector2f& position) const {
+
+    return (rank == 0 || position.x >= stripBegin) && (rank + 1 == ranks || position.x < stripEnd);
+}
+
+// Send migrants and halo agents, receive the neighbours' (throws if a neighbour fails)
+void DistributedPartition::exchange(const std::vector<Agent>& agents, std::vector<size_t>& departures, std::vector<Agent>& arrivals, std::vector<Agent>& ghosts) {
+
+    // Sort the agents near or beyond the strip edges by neighbour
+    for (auto& neighbour : neighbours) {
+        neighbour.migrants.clear();
+        neighbour.halo.clear();
+    }
+    departures.clear();
+    for (size_t index = 0; index < agents.size(); ++index) {
+
+        float x = agents[index].position.x;
+        for (auto& neighbour : neighbours) {
+            if (neighbour.left ? x < stripBegin : x >= stripEnd) {
+                neighbour.migrants.push_back(index);
+                departures.push_back(index);
+            } else if (neighbour.left ? x < stripBegin + halo : x >= stripEnd - halo) {
+                neighbour.halo.push_back(index);
+            }
+        }
+    }
+
+    // Serialize and send on helper threads
+    std::vector<std::thread> senders;
+    for (auto& neighbour : neighbours) {
+
+        std::ostringstream message;
+        CheckpointWriter writer(message);
+        writer.write(static_cast<uint64_t>(neighbour.migrants.size()));
+        for (size_t index : neighbour.migrants) {
+            agents[index].save(writer);
+        }
+        writer.write(static_cast<uint64_t>(neighbour.halo.size()));
+        for (size_t index : neighbour.halo) {
+            agents[index].save(writer);
+        }
+        neighbour.outgoing = message.str();
+
+        senders.emplace_back([&neighbour]() {
+            neighbour.sent = neighbour.socket.sendMessage(Distributed::Agents, neighbour.outgoing);
+        });
+    }
+
+    // Receive the neighbours' messages meanwhile
+    arrivals.clear();
+    size_t numGhosts = 0;
+    for (auto& neighbour : neighbours) {
+        receive(neighbour, arrivals, ghosts, numGhosts);
+    }
+    for (auto& sender : senders) {
+        sender.join();
+    }
+    for (auto& neighbour : neighbours) {
+        if (!neighbour.sent) {
+            throw std::runtime_error("Lost the connection to rank " + std::to_string(neighbour.rank));
+        }
+    }
+
+    // Drop the ghost buffers beyond this frame's ghosts
+    while (ghosts.size() > numGhosts) {
+        ghosts.pop_back();
+    }
+
+    stats.arrivals = arrivals.size();
+    stats.departures = departures.size();
+    stats.ghosts = numGhosts;
+}
+
+// Receive one neighbour's migrants and ghosts (ghost buffers are reused)
+void DistributedPartition::receive(Neighbour& neighbour, std::vector<Agent>& arrivals, std::vector<Agent>& ghosts, size_t& numGhosts) {
+
+    uint32_t type = 0;
+    std::string payload;
+    if (!neighbour.socket.receiveMessage(type, payload) || type != Distributed::Agents) {
+        throw std::runtime_error("Lost the connection to rank " + std::to_string(neighbour.rank));
+    }
+
+    std::istringstream message(payload);
+    CheckpointReader reader(message);
+
+    size_t numMigrants = reader.readSize();
+    for (size_t i = 0; i < numMigrants && reader.good(); ++i) {
+        arrivals.emplace_back(Agent::AgentTypeAttributes{});
+        arrivals.back().load(reader);
+    }
+
+    size_t numHalo = reader.readSize();
+    for (size_t i = 0; i < numHalo && reader.good(); ++i) {
+        if (numGhosts == ghosts.size()) {
+            ghosts.emplace_back(Agent::AgentTypeAttributes{});
+        }
+        ghosts[numGhosts++].load(reader);
+    }
+
+    if (!reader.good()) {
+        throw std::runtime_error("Corrupt agent message from rank " + std::to_string(neighbour.rank));
+    }
+}
+
+// Frame barrier at the coordinator, false if the run is to stop
+bool DistributedPartition::synchronize(uint64_t frame, size_t numAgents) {
+
+    stats.frame = frame;
+    stats.agents = numAgents;
+
+    std::ostringstream message;
+    CheckpointWriter writer(message);
+    writer.write(stats);
+
+    uint32_t type = 0;
+    std::string payload;
+    if (!coordinator.sendMessage(Distributed::FrameDone, message.str()) || !coordinator.receiveMessage(type, payload) || type != Distributed::Continue) {
+        DEBUG_MSG("Distributed: rank " << rank << " stopped by the coordinator at frame " << frame);
+        stopped = true;
+        return false;
+    }
+    return true;
+}
+
+// Report the last frame to the coordinator
+void DistributedPartition::finish(uint64_t frame, size_t numAgents) {
+
+    if (stopped) {
+        return;
+    }
+    stats.frame = frame;
+    stats.agents = numAgents;
+
+    std::ostringstream message;
+    CheckpointWriter writer(message);
+    writer.write(stats);
+    coordinator.sendMessage(Distributed::Finished, message.str());
+    stopped = true;
+}
@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <mach/mach.h>
+#include <mach/thread_policy.h>
+#endif
+
+#include "../include/EnsembleRunner.hpp"
+#include "../include/Simulation.hpp"
+#include "../include/SharedBuffer.hpp"
+#include "../include/Logging.hpp"
+
+// Ensemble runner constructor
+EnsembleRunner::EnsembleRunner(const YAML::Node& sweep) {
+
+    loadSweep(sweep);
+    buildRuns();
+}
+
+void EnsembleRunner::loadSweep(const YAML::Node& sweep) {
+
+    const YAML::Node& ensemble = sweep["ensemble"];
+
+    // Base configuration of all runs
+    std::string baseConfigPath = ensemble["base_config"] ? ensemble["base_config"].as<std::string>() : "config.yaml";
+    baseConfig = YAML::LoadFile(baseConfigPath);
+
+    // Worker threads (default: one per hardware thread)
+    if (ensemble["threads"]) {
+        numWorkers = ensemble["threads"].as<int>();
+    } else {
+        numWorkers = std::thread::hardware_concurrency();
+    }
+    numWorkers = std::max(numWorkers, 1);
+
+    if (ensemble["pin_threads"]) {
+        pinThreads = ensemble["pin_threads"].as<bool>();
+    }
+    if (ensemble["repetitions"]) {
+        repetitions = std::max(ensemble["repetitions"].as<int>(), 1);
+    }
+
+    // Parameters in document order, each a config path and its values
+    if (ensemble["parameters"]) {
+        for (const auto& parameter : ensemble["parameters"]) {
+            std::vector<YAML::Node> values;
+            if (parameter.second.IsSequence()) {
+                for (const auto& value : parameter.second) {
+                    values.push_back(value);
+                }
+            } else {
+                values.push_back(parameter.second);
+            }
+            parameters.emplace_back(parameter.first.as<std::string>(), values);
+        }
+    }
+}
+
+// Cartesian product of the parameter values, times the repetitions
+void EnsembleRunner::buildRuns() {
+
+    size_t numCombinations = 1;
+    for (const auto& parameter : parameters) {
+        numCombinations *= parameter.second.size();
+    }
+    size_t numRuns = numCombinations * repetitions;
+    int nameWidth = static_cast<int>(std::to_string(numRuns - 1).size());
+
+    // Parameters that the runner sets unless they are swept
+    auto isSwept = [this](const std::string& path) {
+        return std::any_of(parameters.begin(), parameters.end(), [&](const auto& parameter) { return parameter.first == path; });
+    };
+    bool sweepSeed = isSwept("simulation.seed");
+    bool sweepThreads = isSwept("simulation.num_threads");
+
+    runs.reserve(numRuns);
+    for (size_t combination = 0; combination < numCombinations; ++combination) {
+        for (int repetition = 0; repetition < repetitions; ++repetition) {
+            Run run;
+            std::ostringstream name;
+            name << "run" << std::setfill('0') << std::setw(nameWidth) << runs.size();
+            run.name = name.str();
+
+            // Own copy of the base configuration (nodes are not shared between threads)
+            run.config = YAML::Clone(baseConfig);
+
+            // Parameter values of the combination, the last parameter varying fastest
+            std::vector<size_t> valueIndices(parameters.size());
+            size_t remainder = combination;
+            for (size_t p = parameters.size(); p-- > 0;) {
+                valueIndices[p] = remainder % parameters[p].second.size();
+                remainder /= parameters[p].second.size();
+            }
+            std::ostringstream description;
+            for (size_t p = 0; p < parameters.size(); ++p) {
+                const auto& [path, values] = parameters[p];
+                const YAML::Node& value = values[valueIndices[p]];
+                setValue(run.config, path, value);
+                description << path << "=" << (value.IsScalar() ? value.as<std::string>() : "<" + std::to_string(value.size()) + " entries>") << " ";
+            }
+
+            // Consecutive seeds for the repetitions of a combination
+            if (!sweepSeed && baseConfig["simulation"]["seed"]) {
+                uint64_t seed = baseConfig["simulation"]["seed"].as<uint64_t>() + repetition;
+                run.config["simulation"]["seed"] = seed;
+            }
+            description << "repetition=" << repetition;
+            run.description = description.str();
+
+            // The workers are the parallelism: one initialization thread per run
+            if (!sweepThreads) {
+                run.config["simulation"]["num_threads"] = 1;
+            }
+
+            // Per-run output namespace: database names and output files
+            std::string suffix = "_" + run.name;
+            if (run.config["database"] && run.config["database"]["db_name"]) {
+                run.config["database"]["db_name"] = run.config["database"]["db_name"].as<std::string>() + suffix;
+            }
+            if (run.config["simulation"]["checkpoint"] && run.config["simulation"]["checkpoint"]["output"]) {
+                run.config["simulation"]["checkpoint"]["output"] = run.config["simulation"]["checkpoint"]["output"].as<std::string>() + suffix;
+            }
+            if (run.config["sensors"]) {
+                for (YAML::Node sensorNode : run.config["sensors"]) {
+                    if (sensorNode["database"] && sensorNode["database"]["db_name"]) {
+                        sensorNode["database"]["db_name"] = sensorNode["database"]["db_name"].as<std::string>() + suffix;
+                    }
+                    if (sensorNode["privacy_metrics"] && sensorNode["privacy_metrics"]["output"]) {
+                        sensorNode["privacy_metrics"]["output"] = addSuffix(sensorNode["privacy_metrics"]["output"].as<std::string>(), suffix);
+                    }
+                    if (sensorNode["aggregation"] && sensorNode["aggregation"]["rollup"] && sensorNode["aggregation"]["rollup"]["output"]) {
+                        sensorNode["aggregation"]["rollup"]["output"] = addSuffix(sensorNode["aggregation"]["rollup"]["output"].as<std::string>(), suffix);
+                    }
+                }
+            }
+
+            run.scenarioData = getScenarioData(run.config);
+            runs.push_back(std::move(run));
+        }
+    }
+
+    numWorkers = std::min(numWorkers, static_cast<int>(runs.size()));
+    STATS_MSG("Ensemble: " << runs.size() << " runs (" << numCombinations << " combinations x " << repetitions << " repetitions) on " << numWorkers << " threads, " << scenarioCache.size() << " distinct scenarios");
+}
+
+// Parsed scenario data, shared by all runs with the same taxonomies and obstacles
+std::shared_ptr<const ScenarioData> EnsembleRunner::getScenarioData(const YAML::Node& config) {
+
+    auto dump = [](const YAML::Node& node) { return node ? YAML::Dump(node) : std::string(); };
+    std::string key = dump(config["agents"]["road_user_taxonomy"]) + "\n---\n" + dump(config["region_taxonomy"]) + "\n---\n" + dump(config["obstacles"]) + "\n---\n" + dump(config["collision"]["obstacle_grid"]) + "\n---\n" + dump(config["collision"]["distance_field"]);
+
+    auto cached = scenarioCache.find(key);
+    if (cached != scenarioCache.end()) {
+        return cached->second;
+    }
+
+    auto scenarioData = ScenarioData::load(config);
+    scenarioCache.emplace(key, scenarioData);
+    return scenarioData;
+}
+
+// Execute all runs, returns the number of failed runs
+int EnsembleRunner::run() {
+
+    // The driver instance must exist before the workers create clients
+    Simulation::getMongoInstance();
+
+    std::vector<std::thread> workers;
+    workers.reserve(numWorkers);
+    for (int worker = 0; worker < numWorkers; ++worker) {
+        workers.emplace_back(&EnsembleRunner::runWorker, this, worker);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    STATS_MSG("Ensemble: " << runs.size() - failedRuns.load() << " of " << runs.size() << " runs finished");
+    return failedRuns.load();
+}
+
+// Worker thread: claim runs in order until none are left
+void EnsembleRunner::runWorker(int worker) {
+
+    if (pinThreads) {
+        pinThread(worker % std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    for (size_t index = nextRun.fetch_add(1); index < runs.size(); index = nextRun.fetch_add(1)) {
+        Run& run = runs[index];
+        STATS_MSG("Ensemble: " << run.name << " started on thread " << worker << " (" << run.description << ")");
+
+        // Buffers without a reader: frames are counted, not stored
+        SharedBuffer<agentBufferFrameType> agentBuffer("Agents " + run.name);
+        SharedBuffer<sensorBufferFrameType> sensorBuffer("Sensors " + run.name);
+        agentBuffer.discardFrames = true;
+        sensorBuffer.discardFrames = true;
+
+        try {
+            std::atomic<float> currentSimulationTimeStep{run.config["simulation"]["time_step"].as<float>()};
+            Simulation simulation(agentBuffer, sensorBuffer, currentSimulationTimeStep, run.config, run.scenarioData);
+            simulation.run();
+            STATS_MSG("Ensemble: " << run.name << " finished");
+        } catch (const std::exception& e) {
+            ++failedRuns;
+            ERROR_MSG("Ensemble: " << run.name << " failed: " << e.what());
+        }
+
+        // Release the run's configuration and scenario reference
+        run.config = YAML::Node();
+        run.scenarioData.reset();
+    }
+}
+
+// Set a value at a dotted path (e.g. agents.num_agents), creating missing maps
+void EnsembleRunner::setValue(YAML::Node root, const std::string& path, const YAML::Node& value) {
+
+    std::vector<std::string> keys;
+    std::stringstream stream(path);
+    std::string key;
+    while (std::getline(stream, key, '.')) {
+        keys.push_back(key);
+    }
+
+    // Walk down with reset (assignment would overwrite the parent's value)
+    YAML::Node node = root;
+    for (size_t i = 0; i + 1 < keys.size(); ++i) {
+        node.reset(node[keys[i]]);
+    }
+    node[keys.back()] = YAML::Clone(value);
+}
+
+// Insert a suffix before the file extension, e.g. metrics.csv -> metrics_run007.csv
+std::string EnsembleRunner::addSuffix(const std::string& name, const std::string& suffix) {
+
+    size_t dot = name.find_last_of('.');
+    size_t slash = name.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return name + suffix;
+    }
+    return name.substr(0, dot) + suffix + name.substr(dot);
+}
+
+// Pin the calling thread to a core (threads it creates inherit the affinity on Linux)
+void EnsembleRunner::pinThread(int core) {
+
+#if defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+        ERROR_MSG("Ensemble: could not pin thread to core " << core);
+    }
+#elif defined(__APPLE__)
+    // No hard affinity on macOS: distinct affinity tags ask the scheduler to keep threads apart
+    thread_affinity_policy_data_t policy = {core + 1};
+    thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_AFFINITY_POLICY,
+                      reinterpret_cast<thread_policy_t>(&policy), THREAD_AFFINITY_POLICY_COUNT);
+#else
+    (void)core;
+#endif
+}
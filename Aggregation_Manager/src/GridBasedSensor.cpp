@@ -10,7 +10,7 @@
 // Constructor
 GridBasedSensor::GridBasedSensor(
     float frameRate,
-    sf::FloatRect detectionArea,
+    sim::FloatRect detectionArea,
     float cellSize,
     const std::string& databaseName,
     const std::string& collectionName,
@@ -29,8 +29,8 @@ GridBasedSensor::GridBasedSensor(
 
 // Alternative constructor for rendering
 GridBasedSensor::GridBasedSensor(
-    sf::FloatRect detectionArea, 
-    sf::Color detectionAreaColor, 
+    sim::FloatRect detectionArea, 
+    sim::Color detectionAreaColor, 
     float cellSize, 
     bool showGrid,
     SharedBuffer<sensorBufferFrameType>& sensorBuffer
@@ -54,19 +54,16 @@ GridBasedSensor::~GridBasedSensor() {
 }
 
 // Update grid-based agent detection and output one gridData entry per frame
-void GridBasedSensor::update(std::vector<Agent>& agents, float timeStep, std::chrono::system_clock::time_point timestamp) {
+void GridBasedSensor::update(std::vector<Agent>& agents, const SimulationClock& clock) {
 
-    // Update current timestamp
-    this->timestamp = timestamp;
+    // Update current timestamp, the time of the agent states
+    this->timestamp = clock.getPreviousTimestamp();
 
     // Clear data storage
     dataStorage.clear();
 
-    // Update the time since the last update
-    timeSinceLastUpdate += timeStep;
-
     // Update the estimated velocities at the specified frame rate
-    if (timeSinceLastUpdate >= 1.0f / frameRate) {
+    if (isUpdateDue(clock)) {
 
         // Clear the grid data
         gridData.clear();
@@ -79,7 +76,7 @@ void GridBasedSensor::update(std::vector<Agent>& agents, float timeStep, std::ch
         bool hasAgents = false;
 
         // Declare a variable to store the cell index
-        sf::Vector2i cellIndex;
+        sim::Vector2i cellIndex;
 
         // Iterate through the agents
         for (Agent& agent : agents) {
@@ -100,10 +97,9 @@ void GridBasedSensor::update(std::vector<Agent>& agents, float timeStep, std::ch
             }
         }
 
-        // Clear the previous positions and reset the time since the last update
+        // Store the grid data if any agent was detected
         if(hasAgents) {
 
-            timeSinceLastUpdate = 0.0f;
             dataStorage.push_back({timestamp, gridData}); // Pushing exactly one entry to dataStorage
         }
     }
@@ -217,7 +213,7 @@ void GridBasedSensor::printData() {
     // Print grid data
     for (const auto& kvp : gridData) { // key-value pair
 
-        const sf::Vector2i& cellIndex = kvp.first;
+        const sim::Vector2i& cellIndex = kvp.first;
         const GridDataPoint& cellData = kvp.second;
 
         std::cout << "Timestamp: " << ss.str() << " Cell (" << cellIndex.x << ", " << cellIndex.y << "): ";
@@ -243,26 +239,26 @@ void GridBasedSensor::clearDatabase() {
 }
 
 // Helper function to get cell index based on position
-sf::Vector2i GridBasedSensor::getCellIndex(const sf::Vector2f& position) const {
+sim::Vector2i GridBasedSensor::getCellIndex(const sim::Vector2f& position) const {
 
     int x = static_cast<int>((position.x - detectionArea.position.x) / cellSize);
     int y = static_cast<int>((position.y - detectionArea.position.y)/ cellSize);
 
-    return sf::Vector2i(x, y);
+    return sim::Vector2i(x, y);
 }
 
-// sf::Vector2f GridBasedSensor::getCellPosition(const sf::Vector2i& cellIndex) const {
+// sim::Vector2f GridBasedSensor::getCellPosition(const sim::Vector2i& cellIndex) const {
 
 //     float x = (cellIndex.x * cellSize + detectionArea.position.x + cellSize / 2);
 //     float y = (cellIndex.y * cellSize + detectionArea.position.y + cellSize / 2);
 
-//     return sf::Vector2f(x, y);
+//     return sim::Vector2f(x, y);
 // }
 
-sf::Vector2f GridBasedSensor::getCellPosition(const sf::Vector2i& cellIndex) const {
+sim::Vector2f GridBasedSensor::getCellPosition(const sim::Vector2i& cellIndex) const {
 
     float x = cellIndex.x * cellSize + detectionArea.position.x;
     float y = cellIndex.y * cellSize + detectionArea.position.y;
 
-    return sf::Vector2f(x, y);
+    return sim::Vector2f(x, y);
 }
\ No newline at end of file
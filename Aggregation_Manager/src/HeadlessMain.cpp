@@ -0,0 +1,77 @@
+#include <yaml-cpp/yaml.h>
+#include <iostream>
+#include <atomic>
+#include <string>
+
+#include "../include/SharedBuffer.hpp"
+#include "../include/Simulation.hpp"
+#include "../include/EnsembleRunner.hpp"
+#include "../include/Coordinator.hpp"
+#include "../include/Logging.hpp"
+
+/***********************************/
+/********** HEADLESS MAIN **********/
+/***********************************/
+
+// Main function of the SFML-free executable: runs the simulation on the main thread without a renderer
+// Usage: SimulatorHeadless [config.yaml] or SimulatorHeadless --ensemble ensemble.yaml
+//        SimulatorHeadless --coordinator config.yaml and SimulatorHeadless --rank r config.yaml (distributed run)
+int main(int argc, char* argv[]) {
+
+    // Ensemble mode: run the sweep concurrently, exit code 1 if any run failed
+    if (argc > 2 && std::string(argv[1]) == "--ensemble") {
+        try {
+            EnsembleRunner ensemble(YAML::LoadFile(argv[2]));
+            return ensemble.run() == 0 ? 0 : 1;
+        } catch (const YAML::Exception& e) {
+            ERROR_MSG("Error loading ensemble file: " << e.what());
+            return 1;
+        }
+    }
+
+    // Distributed run: the coordinator or one rank (the rank overrides distributed.rank)
+    std::string mode = argc > 2 ? argv[1] : "";
+    int rank = -1;
+    if (argc > 3 && mode == "--rank") {
+        rank = std::stoi(argv[2]);
+    }
+
+    // Loading configuration file (path as optional last argument)
+    std::string configPath = argc > 1 ? argv[argc - 1] : "config.yaml";
+    YAML::Node config;
+    try {
+        config = YAML::LoadFile(configPath);
+    } catch (const YAML::Exception& e) {
+        ERROR_MSG("Error loading config file: " << e.what());
+        return 1;
+    }
+
+    if (mode == "--coordinator") {
+        Coordinator coordinator(config);
+        return coordinator.run() ? 0 : 1;
+    }
+    if (rank >= 0) {
+        config["distributed"]["rank"] = rank;
+    }
+
+    // Shared buffers for agent and sensor data (no reader: frames are counted, not stored)
+    SharedBuffer<agentBufferFrameType> agentBuffer("Agents");
+    SharedBuffer<sensorBufferFrameType> sensorBuffer("Sensors");
+    agentBuffer.discardFrames = true;
+    sensorBuffer.discardFrames = true;
+
+    // Shared variables
+    float timeStep = config["simulation"]["time_step"].as<float>();
+    std::atomic<float> currentSimulationTimeStep{timeStep};
+
+    // An invalid configuration, a failed restore or a lost rank connection ends the run
+    try {
+        Simulation simulation(agentBuffer, sensorBuffer, currentSimulationTimeStep, config);
+        simulation.run();
+    } catch (const std::exception& e) {
+        ERROR_MSG("Simulation failed: " << e.what());
+        return 1;
+    }
+
+    return 0;
+}
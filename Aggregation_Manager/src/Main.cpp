@@ -3,6 +3,7 @@
 #include <yaml-cpp/yaml.h>
 #include <iostream>
 #include <atomic>
+#include <memory>
 
 #include "../include/SharedBuffer.hpp"
 // #include "../include/QuadtreeSnapshot.hpp"
@@ -44,8 +45,15 @@ int main() {
     // Shared variabes
     std::atomic<float> currentSimulationTimeStep{timeStep};
 
-    Simulation simulation(agentBuffer, sensorBuffer, currentSimulationTimeStep, config);
-    std::thread simulationThread(&Simulation::run, &simulation);
+    // An invalid configuration or a failed restore ends the program
+    std::unique_ptr<Simulation> simulation;
+    try {
+        simulation = std::make_unique<Simulation>(agentBuffer, sensorBuffer, currentSimulationTimeStep, config);
+    } catch (const std::exception& e) {
+        ERROR_MSG("Error initializing simulation: " << e.what());
+        return 1;
+    }
+    std::thread simulationThread(&Simulation::run, simulation.get());
 
     // Run the renderer if not in headless mode
     if (enableRendering) {
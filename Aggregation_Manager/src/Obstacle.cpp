@@ -1,5 +1,75 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
 #include "../include/Obstacle.hpp"
 
 // Constructor for the Obstacle class
-Obstacle::Obstacle(sf::FloatRect bounds, sf::Color color)
-    : bounds(bounds), color(color) {}
\ No newline at end of file
+Obstacle::Obstacle(sim::FloatRect bounds, sim::Color color)
+    : bounds(bounds), color(color) {}
+
+// Polygon obstacle, the bounds enclose its vertices
+Obstacle::Obstacle(std::vector<sim::Vector2f> vertices, sim::Color color)
+    : color(color), vertices(std::move(vertices)) {
+
+    if (this->vertices.empty()) {
+        return;
+    }
+    sim::Vector2f low = this->vertices.front();
+    sim::Vector2f high = low;
+    for (const auto& vertex : this->vertices) {
+        low = {std::min(low.x, vertex.x), std::min(low.y, vertex.y)};
+        high = {std::max(high.x, vertex.x), std::max(high.y, vertex.y)};
+    }
+    bounds = sim::FloatRect(low, high - low);
+}
+
+// Whether a point lies inside the obstacle (even-odd rule for polygons)
+bool Obstacle::contains(const sim::Vector2f& point) const {
+
+    if (!isPolygon()) {
+        float minX = std::min(bounds.position.x, bounds.position.x + bounds.size.x);
+        float minY = std::min(bounds.position.y, bounds.position.y + bounds.size.y);
+        return point.x >= minX && point.x <= minX + std::abs(bounds.size.x) && point.y >= minY && point.y <= minY + std::abs(bounds.size.y);
+    }
+
+    bool inside = false;
+    for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+        const sim::Vector2f& a = vertices[i];
+        const sim::Vector2f& b = vertices[j];
+        if ((a.y > point.y) != (b.y > point.y) && point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// Signed distance of a point to the outline, negative inside
+float Obstacle::getSignedDistance(const sim::Vector2f& point) const {
+
+    // Rectangle: distance to the box, or minus the distance to the nearest side inside
+    if (!isPolygon()) {
+        sim::Vector2f halfSize(std::abs(bounds.size.x) * 0.5f, std::abs(bounds.size.y) * 0.5f);
+        sim::Vector2f center(std::min(bounds.position.x, bounds.position.x + bounds.size.x) + halfSize.x,
+                             std::min(bounds.position.y, bounds.position.y + bounds.size.y) + halfSize.y);
+        float dx = std::abs(point.x - center.x) - halfSize.x;
+        float dy = std::abs(point.y - center.y) - halfSize.y;
+        float outside = std::hypot(std::max(dx, 0.0f), std::max(dy, 0.0f));
+        return outside + std::min(std::max(dx, dy), 0.0f);
+    }
+
+    // Polygon: distance to the nearest edge, negative inside
+    float distanceSquared = std::numeric_limits<float>::max();
+    for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+        sim::Vector2f edge = vertices[i] - vertices[j];
+        sim::Vector2f offset = point - vertices[j];
+        float lengthSquared = edge.x * edge.x + edge.y * edge.y;
+        float t = lengthSquared > 0.0f ? std::clamp((offset.x * edge.x + offset.y * edge.y) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+        float dx = offset.x - edge.x * t;
+        float dy = offset.y - edge.y * t;
+        distanceSquared = std::min(distanceSquared, dx * dx + dy * dy);
+    }
+    float distance = std::sqrt(distanceSquared);
+    return contains(point) ? -distance : distance;
+}
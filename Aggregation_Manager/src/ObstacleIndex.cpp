@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <cmath>
+
+#include "../include/ObstacleIndex.hpp"
+#include "../include/Logging.hpp"
+
+namespace {
+
+constexpr size_t maxCells = size_t(1) << 22;
+
+// Entry fraction of the segment start + t * delta (t in [0, 1]) into a box, 0 if it starts inside
+float segmentBoxEntry(const sim::Vector2f& start, const sim::Vector2f& delta, const sim::Vector2f& low, const sim::Vector2f& high) {
+
+    const float origin[2] = {start.x, start.y};
+    const float direction[2] = {delta.x, delta.y};
+    const float lows[2] = {low.x, low.y};
+    const float highs[2] = {high.x, high.y};
+
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    for (int axis = 0; axis < 2; ++axis) {
+        if (std::abs(direction[axis]) < 1e-12f) {
+            if (origin[axis] < lows[axis] || origin[axis] > highs[axis]) return ObstacleIndex::noHit;
+            continue;
+        }
+        float t0 = (lows[axis] - origin[axis]) / direction[axis];
+        float t1 = (highs[axis] - origin[axis]) / direction[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax) return ObstacleIndex::noHit;
+    }
+    return tMin;
+}
+
+// Entry fraction of the segment into a circle, 0 if it starts inside
+float segmentCircleEntry(const sim::Vector2f& start, const sim::Vector2f& delta, const sim::Vector2f& center, float radius) {
+
+    sim::Vector2f offset = start - center;
+    float c = offset.x * offset.x + offset.y * offset.y - radius * radius;
+    if (c <= 0.0f) return 0.0f;
+
+    float a = delta.x * delta.x + delta.y * delta.y;
+    float b = offset.x * delta.x + offset.y * delta.y;
+    if (a <= 0.0f || b >= 0.0f) return ObstacleIndex::noHit; // Not moving or moving away
+
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) return ObstacleIndex::noHit;
+    float t = (-b - std::sqrt(discriminant)) / a;
+    return t <= 1.0f ? t : ObstacleIndex::noHit;
+}
+
+// Entry fraction of a circle swept along the segment into a rectangle (the rectangle grown by the radius, rounded corners)
+float sweptCircleRectEntry(const sim::Vector2f& start, const sim::Vector2f& delta, float radius, const sim::FloatRect& rect) {
+
+    sim::Vector2f low = rect.position;
+    sim::Vector2f high = rect.position + rect.size;
+
+    // Miss of the grown rectangle with square corners
+    if (segmentBoxEntry(start, delta, {low.x - radius, low.y - radius}, {high.x + radius, high.y + radius}) == ObstacleIndex::noHit) {
+        return ObstacleIndex::noHit;
+    }
+
+    // Rounded rectangle: the rectangle grown along each axis and a circle at each corner
+    float t = std::min(segmentBoxEntry(start, delta, {low.x - radius, low.y}, {high.x + radius, high.y}),
+                       segmentBoxEntry(start, delta, {low.x, low.y - radius}, {high.x, high.y + radius}));
+    t = std::min(t, segmentCircleEntry(start, delta, low, radius));
+    t = std::min(t, segmentCircleEntry(start, delta, {high.x, low.y}, radius));
+    t = std::min(t, segmentCircleEntry(start, delta, {low.x, high.y}, radius));
+    t = std::min(t, segmentCircleEntry(start, delta, high, radius));
+    return t;
+}
+
+// Entry fraction of a circle swept along the segment into a polygon (a capsule around every edge), once its bounds are hit
+float sweptCirclePolygonEntry(const sim::Vector2f& start, const sim::Vector2f& delta, float radius, const Obstacle& polygon) {
+
+    if (polygon.getSignedDistance(start) <= radius) {
+        return 0.0f;
+    }
+
+    // Every vertex starts an edge, so the circles at the edge ends are covered by the edge starts
+    const std::vector<sim::Vector2f>& vertices = polygon.getVertices();
+    float t = ObstacleIndex::noHit;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const sim::Vector2f& a = vertices[i];
+        sim::Vector2f edge = vertices[(i + 1) % vertices.size()] - a;
+        t = std::min(t, segmentCircleEntry(start, delta, a, radius));
+
+        // Edge frame: the edge runs along x from 0 to its length
+        float length = std::hypot(edge.x, edge.y);
+        if (length <= 0.0f) continue;
+        sim::Vector2f u(edge.x / length, edge.y / length);
+        sim::Vector2f offset = start - a;
+        sim::Vector2f localStart(offset.x * u.x + offset.y * u.y, offset.y * u.x - offset.x * u.y);
+        sim::Vector2f localDelta(delta.x * u.x + delta.y * u.y, delta.y * u.x - delta.x * u.y);
+        t = std::min(t, segmentBoxEntry(localStart, localDelta, {0.0f, -radius}, {length, radius}));
+    }
+    return t;
+}
+
+} // namespace
+
+// Bucket the obstacles into a uniform grid over their bounding box
+void ObstacleIndex::build(const std::vector<Obstacle>& obstacles, float cellSize) {
+
+    rects.clear();
+    polygons.clear();
+    cellStart.clear();
+    cellObstacles.clear();
+    columns = 0;
+    rows = 0;
+    if (obstacles.empty()) {
+        return;
+    }
+
+    // Bounds with positive sizes and the bounding box of all obstacles
+    sim::Vector2f low(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    sim::Vector2f high(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+    float totalExtent = 0.0f;
+    rects.reserve(obstacles.size());
+    for (const auto& obstacle : obstacles) {
+        if (obstacle.isPolygon()) {
+            polygons.emplace(static_cast<uint32_t>(rects.size()), obstacle);
+        }
+        sim::FloatRect bounds = obstacle.getBounds();
+        sim::Vector2f first(std::min(bounds.position.x, bounds.position.x + bounds.size.x), std::min(bounds.position.y, bounds.position.y + bounds.size.y));
+        sim::Vector2f size(std::abs(bounds.size.x), std::abs(bounds.size.y));
+        rects.emplace_back(first, size);
+
+        low = {std::min(low.x, first.x), std::min(low.y, first.y)};
+        high = {std::max(high.x, first.x + size.x), std::max(high.y, first.y + size.y)};
+        totalExtent += std::max(size.x, size.y);
+    }
+    sim::Vector2f extent(std::max(high.x - low.x, 1e-3f), std::max(high.y - low.y, 1e-3f));
+
+    // About one obstacle per cell, but cells no smaller than the average obstacle
+    if (cellSize <= 0.0f) {
+        cellSize = std::max(totalExtent / rects.size(), std::sqrt(extent.x * extent.y / rects.size()));
+    }
+    while (static_cast<size_t>(std::ceil(extent.x / cellSize)) * static_cast<size_t>(std::ceil(extent.y / cellSize)) > maxCells) {
+        cellSize *= 2.0f;
+    }
+    this->cellSize = cellSize;
+    origin = low;
+    columns = std::max(static_cast<int>(std::ceil(extent.x / cellSize)), 1);
+    rows = std::max(static_cast<int>(std::ceil(extent.y / cellSize)), 1);
+
+    // Cell range of an obstacle
+    auto cellRange = [this](const sim::FloatRect& rect, int& x0, int& y0, int& x1, int& y1) {
+        x0 = std::clamp(static_cast<int>((rect.position.x - origin.x) / this->cellSize), 0, columns - 1);
+        y0 = std::clamp(static_cast<int>((rect.position.y - origin.y) / this->cellSize), 0, rows - 1);
+        x1 = std::clamp(static_cast<int>((rect.position.x + rect.size.x - origin.x) / this->cellSize), 0, columns - 1);
+        y1 = std::clamp(static_cast<int>((rect.position.y + rect.size.y - origin.y) / this->cellSize), 0, rows - 1);
+    };
+
+    // Count the obstacles per cell, then fill the id lists
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    int x0, y0, x1, y1;
+    for (const auto& rect : rects) {
+        cellRange(rect, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                ++cellStart[y * columns + x + 1];
+            }
+        }
+    }
+    for (size_t cell = 1; cell < cellStart.size(); ++cell) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+    cellObstacles.resize(cellStart.back());
+    std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (uint32_t id = 0; id < rects.size(); ++id) {
+        cellRange(rects[id], x0, y0, x1, y1);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                cellObstacles[fill[y * columns + x]++] = id;
+            }
+        }
+    }
+
+    DEBUG_MSG("Obstacle index: " << rects.size() << " obstacles in " << columns << " x " << rows << " cells of " << cellSize << " m");
+}
+
+// Fraction of the segment at the first contact of the swept circle, noHit if free
+float ObstacleIndex::sweep(const sim::Vector2f& start, const sim::Vector2f& end, float radius) const {
+
+    if (rects.empty()) {
+        return noHit;
+    }
+
+    // Cells overlapping the bounding box of the sweep, nothing if it lies beside the obstacles
+    float minX = std::min(start.x, end.x) - radius - origin.x;
+    float minY = std::min(start.y, end.y) - radius - origin.y;
+    float maxX = std::max(start.x, end.x) + radius - origin.x;
+    float maxY = std::max(start.y, end.y) + radius - origin.y;
+    if (maxX < 0.0f || maxY < 0.0f || minX > columns * cellSize || minY > rows * cellSize) {
+        return noHit;
+    }
+    int x0 = std::clamp(static_cast<int>(minX / cellSize), 0, columns - 1);
+    int y0 = std::clamp(static_cast<int>(minY / cellSize), 0, rows - 1);
+    int x1 = std::clamp(static_cast<int>(maxX / cellSize), 0, columns - 1);
+    int y1 = std::clamp(static_cast<int>(maxY / cellSize), 0, rows - 1);
+
+    // Obstacles spanning several cells are tested once per cell (cheaper than deduplicating)
+    sim::Vector2f delta = end - start;
+    float first = noHit;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            size_t cell = static_cast<size_t>(y) * columns + x;
+            for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                uint32_t id = cellObstacles[i];
+                float entry = sweptCircleRectEntry(start, delta, radius, rects[id]);
+                if (entry != noHit && !polygons.empty()) {
+                    auto polygon = polygons.find(id);
+                    if (polygon != polygons.end()) {
+                        entry = sweptCirclePolygonEntry(start, delta, radius, polygon->second);
+                    }
+                }
+                first = std::min(first, entry);
+                if (first == 0.0f) return first;
+            }
+        }
+    }
+    return first;
+}
+
+// Sweep a batch of circles
+void ObstacleIndex::sweep(SweptCircleBatch& batch) const {
+
+    size_t count = batch.start.size();
+    batch.hit.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        batch.hit[i] = sweep(batch.start[i], batch.end[i], batch.radius[i]);
+    }
+}
@@ -1,75 +1,398 @@
-#include <algorithm> // For std::iota and std::shuffle
+#include <algorithm> // For std::copy
 #include <cmath>     // For std::floor
+#include <iostream>
 #include <numeric>   // For std::iota
-#include <random>    // For std::default_random_engine
+#include <utility>   // For std::swap
 
 #include "../include/PerlinNoise.hpp"
+#include "../include/Random.hpp"
 
-// Perlin noise class
-PerlinNoise::PerlinNoise(unsigned int seed) {
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-    p.resize(256);
+namespace {
 
-    // Initialize the permutation vector with values 0 to 255
-    std::iota(p.begin(), p.end(), 0);
+// Gradients of the 16 hash values (edges of the unit cube, as in improved Perlin noise)
+constexpr float gradX[16] = {1, -1, 1, -1, 1, -1, 1, -1, 0, 0, 0, 0, 1, 0, -1, 0};
+constexpr float gradY[16] = {1, 1, -1, -1, 0, 0, 0, 0, 1, -1, 1, -1, 1, -1, 1, -1};
+constexpr float gradZ[16] = {0, 0, 0, 0, 1, 1, -1, -1, 1, 1, -1, -1, 0, 1, 0, -1};
 
-    // Shuffle using the provided seed
-    std::default_random_engine engine(seed);
-    std::shuffle(p.begin(), p.end(), engine);
+inline float fade(float t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
 
-    // Duplicate the permutation vector
-    p.insert(p.end(), p.begin(), p.end());
+inline float lerp(float t, float a, float b) {
+    return a + t * (b - a);
 }
 
-// Compute Perlin noise at coordinates x, y, z
-double PerlinNoise::noise(double x, double y, double z) {
+inline float grad(int hash, float x, float y, float z) {
+    int h = hash & 15;
+    return gradX[h] * x + gradY[h] * y + gradZ[h] * z;
+}
 
-    // Find unit cube that contains point
-    int X = static_cast<int>(std::floor(x)) & 255;
-    int Y = static_cast<int>(std::floor(y)) & 255;
-    int Z = static_cast<int>(std::floor(z)) & 255;
+#if defined(__SSE2__)
 
-    // Find relative x, y, z of point in cube
-    x -= std::floor(x);
-    y -= std::floor(y);
-    z -= std::floor(z);
+// Four points per SSE2 register. The permutation lookups stay scalar loads (SSE2 has no
+// gather); everything else runs on all four lanes without branches.
 
-    // Compute fade curves for each of x, y, z
-    double u = fade(x);
-    double v = fade(y);
-    double w = fade(z);
+inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
 
-    // Hash coordinates of the 8 cube corners
-    int A = p[X] + Y;
-    int AA = p[A] + Z;
-    int AB = p[A + 1] + Z;
-    int B = p[X + 1] + Y;
-    int BA = p[B] + Z;
-    int BB = p[B + 1] + Z;
+// Floor through truncation, exact for |v| < 2^31 like the int conversion of the hashes
+inline __m128 floor4(__m128 v) {
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, v), _mm_set1_ps(1.0f)));
+}
 
-    // And add blended results from 8 corners of cube
-    double res = lerp(w, lerp(v, lerp(u, grad(p[AA], x, y, z),
-                                        grad(p[BA], x - 1, y, z)),
-                                lerp(u, grad(p[AB], x, y - 1, z),
-                                    grad(p[BB], x - 1, y - 1, z))),
-                        lerp(v, lerp(u, grad(p[AA + 1], x, y, z - 1),
-                                    grad(p[BA + 1], x - 1, y, z - 1)),
-                            lerp(u, grad(p[AB + 1], x, y - 1, z - 1),
-                                grad(p[BB + 1], x - 1, y - 1, z - 1))));
-    return (res + 1.0) / 2.0;
+inline __m128 fade4(__m128 t) {
+    __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
 }
 
-double PerlinNoise::fade(double t) {
-    return t * t * t * (t * (t * 6 - 15) + 10);
+inline __m128 lerp4(__m128 t, __m128 a, __m128 b) {
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
 }
 
-double PerlinNoise::lerp(double t, double a, double b) {
-    return a + t * (b - a);
+// Gradient of the table above selected with masks: u = x or y, v = y, x or z, signs from bits 0 and 1
+inline __m128 grad4(__m128i hash, __m128 x, __m128 y, __m128 z) {
+    __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+    __m128 uIsX = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+    __m128 vIsY = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+    __m128 vIsX = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_or_si128(h, _mm_set1_epi32(2)), _mm_set1_epi32(14))); // 12 or 14
+    __m128 u = select(uIsX, x, y);
+    __m128 v = select(vIsY, y, select(vIsX, x, z));
+    __m128 uSign = _mm_castsi128_ps(_mm_slli_epi32(h, 31));
+    __m128 vSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_srli_epi32(h, 1), 31));
+    return _mm_add_ps(_mm_xor_ps(u, uSign), _mm_xor_ps(v, vSign));
 }
 
-double PerlinNoise::grad(int hash, double x, double y, double z) {
-    int h = hash & 15;
-    double u = h < 8 ? x : y;
-    double v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
-    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
-}
\ No newline at end of file
+inline __m128i load4(const int32_t* values) {
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(values));
+}
+
+// Improved Perlin noise at four points
+void perlin4(const int32_t* p, const float* x, const float* y, const float* z, float* out) {
+
+    // Unit cubes and relative positions within them
+    __m128 vx = _mm_loadu_ps(x);
+    __m128 vy = _mm_loadu_ps(y);
+    __m128 vz = _mm_loadu_ps(z);
+    __m128 floorX = floor4(vx);
+    __m128 floorY = floor4(vy);
+    __m128 floorZ = floor4(vz);
+    __m128 fx = _mm_sub_ps(vx, floorX);
+    __m128 fy = _mm_sub_ps(vy, floorY);
+    __m128 fz = _mm_sub_ps(vz, floorZ);
+
+    // Hashes of the 8 cube corners, per lane
+    alignas(16) int32_t cube[3][4];
+    alignas(16) int32_t hash[8][4];
+    __m128i mask = _mm_set1_epi32(255);
+    _mm_store_si128(reinterpret_cast<__m128i*>(cube[0]), _mm_and_si128(_mm_cvttps_epi32(floorX), mask));
+    _mm_store_si128(reinterpret_cast<__m128i*>(cube[1]), _mm_and_si128(_mm_cvttps_epi32(floorY), mask));
+    _mm_store_si128(reinterpret_cast<__m128i*>(cube[2]), _mm_and_si128(_mm_cvttps_epi32(floorZ), mask));
+    for (int lane = 0; lane < 4; ++lane) {
+        int A = p[cube[0][lane]] + cube[1][lane];
+        int AA = p[A] + cube[2][lane];
+        int AB = p[A + 1] + cube[2][lane];
+        int B = p[cube[0][lane] + 1] + cube[1][lane];
+        int BA = p[B] + cube[2][lane];
+        int BB = p[B + 1] + cube[2][lane];
+        hash[0][lane] = p[AA];
+        hash[1][lane] = p[BA];
+        hash[2][lane] = p[AB];
+        hash[3][lane] = p[BB];
+        hash[4][lane] = p[AA + 1];
+        hash[5][lane] = p[BA + 1];
+        hash[6][lane] = p[AB + 1];
+        hash[7][lane] = p[BB + 1];
+    }
+
+    // Blend the gradients of the corners
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 gx = _mm_sub_ps(fx, one);
+    __m128 gy = _mm_sub_ps(fy, one);
+    __m128 gz = _mm_sub_ps(fz, one);
+    __m128 u = fade4(fx);
+    __m128 v = fade4(fy);
+    __m128 w = fade4(fz);
+    __m128 res = lerp4(w, lerp4(v, lerp4(u, grad4(load4(hash[0]), fx, fy, fz),
+                                            grad4(load4(hash[1]), gx, fy, fz)),
+                                   lerp4(u, grad4(load4(hash[2]), fx, gy, fz),
+                                            grad4(load4(hash[3]), gx, gy, fz))),
+                          lerp4(v, lerp4(u, grad4(load4(hash[4]), fx, fy, gz),
+                                            grad4(load4(hash[5]), gx, fy, gz)),
+                                   lerp4(u, grad4(load4(hash[6]), fx, gy, gz),
+                                            grad4(load4(hash[7]), gx, gy, gz))));
+    _mm_storeu_ps(out, _mm_mul_ps(_mm_add_ps(res, one), _mm_set1_ps(0.5f)));
+}
+
+// Simplex noise at four points
+void simplex4(const int32_t* p, const float* x, const float* y, const float* z, float* out) {
+
+    const __m128 G3 = _mm_set1_ps(1.0f / 6.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    // Skew the input space to find the simplex cell
+    __m128 vx = _mm_loadu_ps(x);
+    __m128 vy = _mm_loadu_ps(y);
+    __m128 vz = _mm_loadu_ps(z);
+    __m128 s = _mm_mul_ps(_mm_add_ps(_mm_add_ps(vx, vy), vz), _mm_set1_ps(1.0f / 3.0f));
+    __m128 floorI = floor4(_mm_add_ps(vx, s));
+    __m128 floorJ = floor4(_mm_add_ps(vy, s));
+    __m128 floorK = floor4(_mm_add_ps(vz, s));
+
+    // Unskewed distances from the cell origin
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(floorI, floorJ), floorK), G3);
+    __m128 x0 = _mm_sub_ps(vx, _mm_sub_ps(floorI, t));
+    __m128 y0 = _mm_sub_ps(vy, _mm_sub_ps(floorJ, t));
+    __m128 z0 = _mm_sub_ps(vz, _mm_sub_ps(floorK, t));
+
+    // Offsets of the second and third corner, ranked by the coordinates
+    __m128 xy = _mm_cmpge_ps(x0, y0);
+    __m128 xz = _mm_cmpge_ps(x0, z0);
+    __m128 yx = _mm_cmpgt_ps(y0, x0);
+    __m128 yz = _mm_cmpge_ps(y0, z0);
+    __m128 zx = _mm_cmpgt_ps(z0, x0);
+    __m128 zy = _mm_cmpgt_ps(z0, y0);
+    __m128 i1 = _mm_and_ps(_mm_and_ps(xy, xz), one);
+    __m128 j1 = _mm_and_ps(_mm_and_ps(yx, yz), one);
+    __m128 k1 = _mm_and_ps(_mm_and_ps(zx, zy), one);
+    __m128 i2 = _mm_and_ps(_mm_or_ps(xy, xz), one);
+    __m128 j2 = _mm_and_ps(_mm_or_ps(yx, yz), one);
+    __m128 k2 = _mm_and_ps(_mm_or_ps(zx, zy), one);
+
+    // Distances from the other three corners
+    __m128 G3x2 = _mm_set1_ps(2.0f * (1.0f / 6.0f));
+    __m128 G3x3 = _mm_set1_ps(3.0f * (1.0f / 6.0f));
+    __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, i1), G3);
+    __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, j1), G3);
+    __m128 z1 = _mm_add_ps(_mm_sub_ps(z0, k1), G3);
+    __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, i2), G3x2);
+    __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, j2), G3x2);
+    __m128 z2 = _mm_add_ps(_mm_sub_ps(z0, k2), G3x2);
+    __m128 x3 = _mm_add_ps(_mm_sub_ps(x0, one), G3x3);
+    __m128 y3 = _mm_add_ps(_mm_sub_ps(y0, one), G3x3);
+    __m128 z3 = _mm_add_ps(_mm_sub_ps(z0, one), G3x3);
+
+    // Hashes of the four corners, per lane
+    alignas(16) int32_t cell[3][4];
+    alignas(16) int32_t offset[6][4];
+    alignas(16) int32_t hash[4][4];
+    __m128i mask = _mm_set1_epi32(255);
+    _mm_store_si128(reinterpret_cast<__m128i*>(cell[0]), _mm_and_si128(_mm_cvttps_epi32(floorI), mask));
+    _mm_store_si128(reinterpret_cast<__m128i*>(cell[1]), _mm_and_si128(_mm_cvttps_epi32(floorJ), mask));
+    _mm_store_si128(reinterpret_cast<__m128i*>(cell[2]), _mm_and_si128(_mm_cvttps_epi32(floorK), mask));
+    _mm_store_si128(reinterpret_cast<__m128i*>(offset[0]), _mm_cvttps_epi32(i1));
+    _mm_store_si128(reinterpret_cast<__m128i*>(offset[1]), _mm_cvttps_epi32(j1));
+    _mm_store_si128(reinterpret_cast<__m128i*>(offset[2]), _mm_cvttps_epi32(k1));
+    _mm_store_si128(reinterpret_cast<__m128i*>(offset[3]), _mm_cvttps_epi32(i2));
+    _mm_store_si128(reinterpret_cast<__m128i*>(offset[4]), _mm_cvttps_epi32(j2));
+    _mm_store_si128(reinterpret_cast<__m128i*>(offset[5]), _mm_cvttps_epi32(k2));
+    for (int lane = 0; lane < 4; ++lane) {
+        int ii = cell[0][lane];
+        int jj = cell[1][lane];
+        int kk = cell[2][lane];
+        hash[0][lane] = p[ii + p[jj + p[kk]]];
+        hash[1][lane] = p[ii + offset[0][lane] + p[jj + offset[1][lane] + p[kk + offset[2][lane]]]];
+        hash[2][lane] = p[ii + offset[3][lane] + p[jj + offset[4][lane] + p[kk + offset[5][lane]]]];
+        hash[3][lane] = p[ii + 1 + p[jj + 1 + p[kk + 1]]];
+    }
+
+    // Radially symmetric falloff of every corner, clamped at zero
+    __m128 limit = _mm_set1_ps(0.6f);
+    __m128 zero = _mm_setzero_ps();
+    __m128 t0 = _mm_max_ps(_mm_sub_ps(_mm_sub_ps(_mm_sub_ps(limit, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0)), _mm_mul_ps(z0, z0)), zero);
+    __m128 t1 = _mm_max_ps(_mm_sub_ps(_mm_sub_ps(_mm_sub_ps(limit, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1)), _mm_mul_ps(z1, z1)), zero);
+    __m128 t2 = _mm_max_ps(_mm_sub_ps(_mm_sub_ps(_mm_sub_ps(limit, _mm_mul_ps(x2, x2)), _mm_mul_ps(y2, y2)), _mm_mul_ps(z2, z2)), zero);
+    __m128 t3 = _mm_max_ps(_mm_sub_ps(_mm_sub_ps(_mm_sub_ps(limit, _mm_mul_ps(x3, x3)), _mm_mul_ps(y3, y3)), _mm_mul_ps(z3, z3)), zero);
+    t0 = _mm_mul_ps(t0, t0);
+    t1 = _mm_mul_ps(t1, t1);
+    t2 = _mm_mul_ps(t2, t2);
+    t3 = _mm_mul_ps(t3, t3);
+
+    __m128 res = _mm_mul_ps(_mm_mul_ps(t0, t0), grad4(load4(hash[0]), x0, y0, z0));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_mul_ps(t1, t1), grad4(load4(hash[1]), x1, y1, z1)));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_mul_ps(t2, t2), grad4(load4(hash[2]), x2, y2, z2)));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_mul_ps(t3, t3), grad4(load4(hash[3]), x3, y3, z3)));
+
+    // Scale to [-1, 1], then to [0, 1]
+    _mm_storeu_ps(out, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(res, _mm_set1_ps(32.0f)), one), _mm_set1_ps(0.5f)));
+}
+
+#endif
+
+} // namespace
+
+// Shuffle the permutation table with the provided seed
+PerlinNoise::PerlinNoise(uint64_t seed, Type type) : type(type) {
+
+    // Initialize the permutation with values 0 to 255
+    std::iota(p.begin(), p.begin() + 256, 0);
+
+    // Fisher-Yates shuffle with the noise stream of the seed (same table on every platform)
+    Philox4x32 generator(seed, RandomStream::id(RandomStream::Noise, 0));
+    for (uint32_t i = 255; i > 0; --i) {
+        std::swap(p[i], p[generator.uniformIndex(i + 1)]);
+    }
+
+    // Duplicate the permutation to avoid wrapping indices
+    std::copy(p.begin(), p.begin() + 256, p.begin() + 256);
+}
+
+PerlinNoise::Type PerlinNoise::parseType(const std::string& name) {
+
+    if (name == "simplex") {
+        return Type::Simplex;
+    }
+    if (name != "perlin") {
+        ERROR_MSG("Unknown noise type '" << name << "', using perlin");
+    }
+
+    return Type::Perlin;
+}
+
+// Compute noise at coordinates x, y, z
+float PerlinNoise::noise(float x, float y, float z) const {
+
+    float out;
+    noise(&x, &y, &z, &out, 1);
+
+    return out;
+}
+
+// Compute noise for count points
+void PerlinNoise::noise(const float* x, const float* y, const float* z, float* out, size_t count) const {
+
+    if (type == Type::Simplex) {
+        simplexBatch(x, y, z, out, count);
+    } else {
+        perlinBatch(x, y, z, out, count);
+    }
+}
+
+void PerlinNoise::perlinBatch(const float* x, const float* y, const float* z, float* out, size_t count) const {
+
+    // Four points at a time, the remainder one by one
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        perlin4(p.data(), x + i, y + i, z + i, out + i);
+    }
+#endif
+    for (; i < count; ++i) {
+
+        // Find unit cube that contains point
+        float floorX = std::floor(x[i]);
+        float floorY = std::floor(y[i]);
+        float floorZ = std::floor(z[i]);
+        int X = static_cast<int>(floorX) & 255;
+        int Y = static_cast<int>(floorY) & 255;
+        int Z = static_cast<int>(floorZ) & 255;
+
+        // Find relative x, y, z of point in cube
+        float fx = x[i] - floorX;
+        float fy = y[i] - floorY;
+        float fz = z[i] - floorZ;
+
+        // Compute fade curves for each of x, y, z
+        float u = fade(fx);
+        float v = fade(fy);
+        float w = fade(fz);
+
+        // Hash coordinates of the 8 cube corners
+        int A = p[X] + Y;
+        int AA = p[A] + Z;
+        int AB = p[A + 1] + Z;
+        int B = p[X + 1] + Y;
+        int BA = p[B] + Z;
+        int BB = p[B + 1] + Z;
+
+        // And add blended results from 8 corners of cube
+        float res = lerp(w, lerp(v, lerp(u, grad(p[AA], fx, fy, fz),
+                                            grad(p[BA], fx - 1, fy, fz)),
+                                    lerp(u, grad(p[AB], fx, fy - 1, fz),
+                                            grad(p[BB], fx - 1, fy - 1, fz))),
+                            lerp(v, lerp(u, grad(p[AA + 1], fx, fy, fz - 1),
+                                            grad(p[BA + 1], fx - 1, fy, fz - 1)),
+                                    lerp(u, grad(p[AB + 1], fx, fy - 1, fz - 1),
+                                            grad(p[BB + 1], fx - 1, fy - 1, fz - 1))));
+        out[i] = (res + 1.0f) * 0.5f;
+    }
+}
+
+void PerlinNoise::simplexBatch(const float* x, const float* y, const float* z, float* out, size_t count) const {
+
+    constexpr float F3 = 1.0f / 3.0f;
+    constexpr float G3 = 1.0f / 6.0f;
+
+    // Four points at a time, the remainder one by one
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        simplex4(p.data(), x + i, y + i, z + i, out + i);
+    }
+#endif
+    for (; i < count; ++i) {
+
+        // Skew the input space to find the simplex cell
+        float s = (x[i] + y[i] + z[i]) * F3;
+        float floorI = std::floor(x[i] + s);
+        float floorJ = std::floor(y[i] + s);
+        float floorK = std::floor(z[i] + s);
+
+        // Unskewed distances from the cell origin
+        float t = (floorI + floorJ + floorK) * G3;
+        float x0 = x[i] - (floorI - t);
+        float y0 = y[i] - (floorJ - t);
+        float z0 = z[i] - (floorK - t);
+
+        // Offsets of the second and third corner, ranked by the coordinates (without branches)
+        int i1 = (x0 >= y0) & (x0 >= z0);
+        int j1 = (y0 > x0) & (y0 >= z0);
+        int k1 = (z0 > x0) & (z0 > y0);
+        int i2 = (x0 >= y0) | (x0 >= z0);
+        int j2 = (y0 > x0) | (y0 >= z0);
+        int k2 = (z0 > x0) | (z0 > y0);
+
+        // Distances from the other three corners
+        float x1 = x0 - i1 + G3;
+        float y1 = y0 - j1 + G3;
+        float z1 = z0 - k1 + G3;
+        float x2 = x0 - i2 + 2.0f * G3;
+        float y2 = y0 - j2 + 2.0f * G3;
+        float z2 = z0 - k2 + 2.0f * G3;
+        float x3 = x0 - 1.0f + 3.0f * G3;
+        float y3 = y0 - 1.0f + 3.0f * G3;
+        float z3 = z0 - 1.0f + 3.0f * G3;
+
+        // Hash the four corners
+        int ii = static_cast<int>(floorI) & 255;
+        int jj = static_cast<int>(floorJ) & 255;
+        int kk = static_cast<int>(floorK) & 255;
+        int h0 = p[ii + p[jj + p[kk]]];
+        int h1 = p[ii + i1 + p[jj + j1 + p[kk + k1]]];
+        int h2 = p[ii + i2 + p[jj + j2 + p[kk + k2]]];
+        int h3 = p[ii + 1 + p[jj + 1 + p[kk + 1]]];
+
+        // Radially symmetric falloff of every corner, clamped instead of branching
+        float t0 = std::max(0.6f - x0 * x0 - y0 * y0 - z0 * z0, 0.0f);
+        float t1 = std::max(0.6f - x1 * x1 - y1 * y1 - z1 * z1, 0.0f);
+        float t2 = std::max(0.6f - x2 * x2 - y2 * y2 - z2 * z2, 0.0f);
+        float t3 = std::max(0.6f - x3 * x3 - y3 * y3 - z3 * z3, 0.0f);
+        t0 *= t0;
+        t1 *= t1;
+        t2 *= t2;
+        t3 *= t3;
+
+        float res = t0 * t0 * grad(h0, x0, y0, z0)
+                  + t1 * t1 * grad(h1, x1, y1, z1)
+                  + t2 * t2 * grad(h2, x2, y2, z2)
+                  + t3 * t3 * grad(h3, x3, y3, z3);
+
+        // Scale to [-1, 1], then to [0, 1]
+        out[i] = (32.0f * res + 1.0f) * 0.5f;
+    }
+}
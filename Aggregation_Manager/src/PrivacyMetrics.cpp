@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "../include/PrivacyMetrics.hpp"
+
+// Format a bin value like Python does for floats (e.g. 50.0, 1.5)
+static std::string formatBinValue(double value) {
+    std::ostringstream oss;
+    if (value == std::floor(value)) {
+        oss << std::fixed << std::setprecision(1) << value;
+    } else {
+        oss << value;
+    }
+    return oss.str();
+}
+
+PrivacyMetrics::PrivacyMetrics(float speedBinSize, float positionBinSize, float timeWindow, const std::string& outputPath)
+    : speedBinSize(speedBinSize), positionBinSize(positionBinSize), timeWindow(timeWindow), output(outputPath) {
+
+    if (!output.is_open()) {
+        ERROR_MSG("Error: Could not open privacy metrics output " << outputPath);
+        return;
+    }
+
+    // Same columns as privacy_metrics.csv
+    output << "timestamp,speed_bin,position_bin,k_anonymity,l_diversity,delta_presence\n";
+}
+
+PrivacyMetrics::~PrivacyMetrics() {
+
+    // Write the last (partial) time bin
+    flush();
+}
+
+// Add one observation to its equivalence class, closing the previous time bin if it is over
+void PrivacyMetrics::addObservation(
+    std::chrono::system_clock::time_point timestamp,
+    const std::string& agentId,
+    const std::string& agentType,
+    sim::Vector2f position,
+    sim::Vector2f velocity
+) {
+    using namespace std::chrono;
+
+    // Time bin of the observation (truncated to the time window like $dateTrunc)
+    int64_t windowMs = std::max<int64_t>(1, std::llround(timeWindow * 1000.0f));
+    int64_t timeBin = duration_cast<milliseconds>(timestamp.time_since_epoch()).count() / windowMs;
+
+    if (timeBin > currentTimeBin) {
+        flush();
+        currentTimeBin = timeBin;
+        currentTimeBinStart = system_clock::time_point(duration_cast<system_clock::duration>(milliseconds(timeBin * windowMs)));
+    }
+
+    // Quasi-identifiers: speed bin and position bin
+    float speed = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
+    uint64_t key = makeKey(
+        static_cast<int>(std::floor(speed / speedBinSize)),
+        static_cast<int>(std::floor(position.x / positionBinSize)),
+        static_cast<int>(std::floor(position.y / positionBinSize))
+    );
+
+    uint64_t agentHash = std::hash<std::string>{}(agentId);
+
+    ClassStats& stats = classes[key];
+    stats.count++;
+    stats.agentTypeMask |= getAgentTypeBit(agentType);
+    stats.agentHashes.insert(agentHash);
+    timeBinAgentHashes.insert(agentHash);
+}
+
+// Write the rows of the current time bin and start over
+void PrivacyMetrics::flush() {
+
+    if (!classes.empty() && output.is_open()) {
+        writeRows();
+    }
+
+    classes.clear();
+    timeBinAgentHashes.clear();
+}
+
+// Write one row per equivalence class of the current time bin
+void PrivacyMetrics::writeRows() {
+
+    size_t totalDistinctAgents = timeBinAgentHashes.size();
+
+    // Time bin start as "YYYY-MM-DD HH:MM:SS" (UTC)
+    std::time_t t = std::chrono::system_clock::to_time_t(currentTimeBinStart);
+    std::tm utc = *std::gmtime(&t);
+    std::ostringstream timestampStream;
+    timestampStream << std::put_time(&utc, "%Y-%m-%d %H:%M:%S");
+    const std::string timestamp = timestampStream.str();
+
+    for (auto& [key, stats] : classes) {
+
+        size_t distinctAgents = stats.agentHashes.size();
+
+        output << timestamp << ','
+               << formatBinValue(getSpeedBin(key) * static_cast<double>(speedBinSize)) << ','
+               << "\"(" << formatBinValue(getPositionBinX(key) * static_cast<double>(positionBinSize)) << ", "
+               << formatBinValue(getPositionBinY(key) * static_cast<double>(positionBinSize)) << ")\","
+               << stats.count << ','
+               << __builtin_popcountll(stats.agentTypeMask) << ','
+               << static_cast<double>(distinctAgents) / totalDistinctAgents << '\n';
+    }
+
+    output.flush();
+}
+
+// Pack the bins into one key (position bins are offset to stay non-negative)
+uint64_t PrivacyMetrics::makeKey(int speedBin, int positionBinX, int positionBinY) {
+    return (static_cast<uint64_t>(speedBin & 0xFFFF) << 48)
+         | (static_cast<uint64_t>((positionBinX + (1 << 23)) & 0xFFFFFF) << 24)
+         | static_cast<uint64_t>((positionBinY + (1 << 23)) & 0xFFFFFF);
+}
+
+int PrivacyMetrics::getSpeedBin(uint64_t key) {
+    return static_cast<int>(key >> 48);
+}
+
+int PrivacyMetrics::getPositionBinX(uint64_t key) {
+    return static_cast<int>((key >> 24) & 0xFFFFFF) - (1 << 23);
+}
+
+int PrivacyMetrics::getPositionBinY(uint64_t key) {
+    return static_cast<int>(key & 0xFFFFFF) - (1 << 23);
+}
+
+// Get the bit of an agent type for the l-diversity type masks
+uint64_t PrivacyMetrics::getAgentTypeBit(const std::string& agentType) {
+
+    auto it = agentTypeBits.find(agentType);
+    if (it == agentTypeBits.end()) {
+        if (agentTypeBits.size() >= 64) {
+            ERROR_MSG("Error: More than 64 agent types for the privacy metrics, ignoring " << agentType);
+            return 0;
+        }
+        it = agentTypeBits.emplace(agentType, static_cast<int>(agentTypeBits.size())).first;
+    }
+
+    return uint64_t{1} << it->second;
+}
@@ -46,123 +46,6 @@ void Quadtree::Node::split(std::unordered_map<int, Node*>& nodeMap) {
     isSplit = true;
 }
 
-void Quadtree::Node::draw(sf::RenderWindow& window, sf::Font& font) {
-    sf::RectangleShape shape;
-    shape.setSize(sf::Vector2f(bounds.size.x, bounds.size.y));
-    shape.setPosition({bounds.position.x, bounds.position.y});
-    shape.setFillColor(sf::Color::Transparent);
-    shape.setOutlineThickness(1);
-    shape.setOutlineColor(sf::Color::Black);
-
-    window.draw(shape);
-    bool drawText = false;
-
-    if(drawText){
-        sf::Text text(font, "", 24);
-        text.setFont(font);
-        text.setString(std::to_string(id));
-        text.setCharacterSize(9);
-        text.setFillColor(sf::Color::Black);
-
-        sf::FloatRect textBounds = text.getLocalBounds();
-        text.setPosition({
-            bounds.position.x + bounds.size.x / 2 - textBounds.size.x / 2,
-            bounds.position.y + bounds.size.y / 2 - textBounds.size.y / 2
-        });
-        window.draw(text);
-    }
-
-    // **Recursively draw children if the node is split**
-    if (isSplit) {
-        for (int i = 0; i < 4; ++i) {
-            if (children[i])
-                children[i]->draw(window, font);
-        }
-    }
-}
-
-void Quadtree::Node::draw(sf::RenderWindow& window, sf::Font& font, float scale, const sf::Vector2f& offset, bool showCellId) {
-    sf::RectangleShape shape;
-    // Scale the size and offset the position
-    shape.setSize(sf::Vector2f(bounds.size.x * scale, bounds.size.y * scale));
-    shape.setPosition({bounds.position.x * scale + offset.x, bounds.position.y * scale + offset.y});
-    shape.setFillColor(sf::Color::Transparent);
-    shape.setOutlineThickness(1);
-    shape.setOutlineColor(sf::Color::Black);
-    window.draw(shape);
-    
-    // Draw the node id text (also apply scaling and offset)
-    if(this->showCellId){
-        sf::Text text(font, std::to_string(id), 0.5 * scale); // Initialize text with font, string and character size
-        text.setFillColor(sf::Color::Black);
-        sf::FloatRect textBounds = text.getLocalBounds();
-        text.setPosition({
-            bounds.position.x * scale + offset.x + (bounds.size.x * scale - textBounds.size.x) / 2,
-            bounds.position.y * scale + offset.y + (bounds.size.y * scale - textBounds.size.y) / 2
-        });
-        window.draw(text);
-    }
-
-    // Recursively draw children nodes
-    if (isSplit) {
-        for (int i = 0; i < 4; ++i) {
-            if (children[i])
-            // children[i]->drawText = false;
-            children[i]->draw(window, font, scale, offset, showCellId);
-        }
-    }
-}
-
-void Quadtree::Node::draw(sf::RenderWindow& window, sf::Font& font, float scale, const sf::Vector2f& offset) {
-    sf::RectangleShape shape;
-    // Scale the size and offset the position
-    shape.setSize(sf::Vector2f(bounds.size.x * scale, bounds.size.y * scale));
-    shape.setPosition({bounds.position.x * scale + offset.x, bounds.position.y * scale + offset.y});
-    shape.setFillColor(sf::Color::Transparent);
-    shape.setOutlineThickness(1);
-    shape.setOutlineColor(sf::Color::Black);
-    window.draw(shape);
-    
-    // Draw the node id text (also apply scaling and offset)
-    if(showCellId){
-        sf::Text text(font, std::to_string(id), 0.5 * scale); // Initialize text with font, string and character size
-        text.setFillColor(sf::Color::Black);
-        sf::FloatRect textBounds = text.getLocalBounds();
-        text.setPosition({
-            bounds.position.x * scale + offset.x + (bounds.size.x * scale - textBounds.size.x) / 2,
-            bounds.position.y * scale + offset.y + (bounds.size.y * scale - textBounds.size.y) / 2
-        });
-        window.draw(text);
-    }
-
-    // Recursively draw children nodes
-    if (isSplit) {
-        for (int i = 0; i < 4; ++i) {
-            if (children[i])
-            // children[i]->drawText = false;
-            children[i]->draw(window, font, scale, offset);
-        }
-    }
-}
-
-void Quadtree::draw(sf::RenderWindow& window, sf::Font& font, float scale, const sf::Vector2f& offset) {
-    for (Node* n : baseNodes){
-        n->draw(window, font, scale, offset, showCellId);
-    }
-}
-
-void Quadtree::drawPositions(sf::RenderWindow& window, const std::vector<sf::Vector2f>& positions) {
-    float circleSize = 4;
-    sf::CircleShape circle(circleSize);
-    circle.setFillColor(sf::Color::Red);
-    for (const sf::Vector2f& pos : positions) {
-        sf::Vector2f newPos = sf::Vector2f(pos.x, pos.y);
-        newPos -= sf::Vector2f(circleSize, circleSize);
-        circle.setPosition(newPos);
-        window.draw(circle);
-    }
-}
-
 // ========================
 // Quadtree Member Functions
 // ========================
@@ -282,7 +165,7 @@ void Quadtree::splitCell(std::vector<int>& sequence) {
     splitRecursive(baseNode, sequence, 0, nodeMap);
 }
 
-sf::Vector2f Quadtree::getCellCenter(int id) const {
+sim::Vector2f Quadtree::getCellCenter(int id) const {
     auto it = nodeMap.find(id);
     if (it == nodeMap.end())
         throw std::runtime_error("Cell not found.");
@@ -290,20 +173,31 @@ sf::Vector2f Quadtree::getCellCenter(int id) const {
     float x = currentNode->bounds.position.x;
     float y = currentNode->bounds.position.y;
     float size = currentNode->bounds.size.x;
-    return sf::Vector2f(x + size / 2, y + size / 2);
+    return sim::Vector2f(x + size / 2, y + size / 2);
 }
 
-sf::Vector2f Quadtree::getCellPosition(int id) const {
+sim::Vector2f Quadtree::getCellPosition(int id) const {
     auto it = nodeMap.find(id);
     if (it == nodeMap.end())
         throw std::runtime_error("Cell not found.");
     Node* currentNode = it->second;
     float x = currentNode->bounds.position.x;
     float y = currentNode->bounds.position.y;
-    return sf::Vector2f(x, y);
+    return sim::Vector2f(x, y);
+}
+
+sim::FloatRect Quadtree::getCellBounds(int id) const {
+    // Computed from the Morton code, so the cell does not need to exist in the tree.
+    int depth = getDepth(id);
+    uint32_t code = Morton::strip(static_cast<uint32_t>(id), depth);
+    float size = cellSize * 2.0f / static_cast<float>(1 << depth);
+    return sim::FloatRect(
+        {origin.x + Morton::decodeCol(code) * size, origin.y + Morton::decodeRow(code) * size},
+        {size, size}
+    );
 }
 
-sf::Vector2f Quadtree::getCellDimensions(int id) const {
+sim::Vector2f Quadtree::getCellDimensions(int id) const {
     auto it = nodeMap.find(id);
     if (it == nodeMap.end())
         throw std::runtime_error("Cell not found.");
@@ -311,81 +205,57 @@ sf::Vector2f Quadtree::getCellDimensions(int id) const {
     return currentNode->bounds.size;
 }
 
-std::vector<int> Quadtree::getNeighboringCells(int id) {
-    std::vector<int> neighbors;
-    Node* targetNode = getNodeById(id);
-    if (!targetNode) {
-        std::cerr << "Error: Target cell for neighbor search not found.\n";
-        return neighbors;
+int Quadtree::getNeighborId(int id, int dx, int dy) const {
+    return Morton::neighbor(static_cast<uint32_t>(id), dx, dy);
+}
+
+int Quadtree::getNeighborCell(int id, int dx, int dy) const {
+
+    // Same-depth neighbour by dilated-integer arithmetic
+    int neighborId = Morton::neighbor(static_cast<uint32_t>(id), dx, dy);
+    if (neighborId < 0)
+        return -1;
+
+    // Climb to the deepest existing cell covering the neighbour (bounded by the tree depth)
+    for (int depth = Morton::depth(neighborId); depth >= 1; --depth) {
+        if (nodeMap.find(neighborId) != nodeMap.end())
+            return neighborId;
+        neighborId >>= 2;
     }
-    int targetDepth = getDepth(id);
+    return -1;
+}
 
-    // Recursively collect neighbors.
-    std::function<void(Node*, int)> findNeighborsRecursively = [&](Node* node, int depth) {
-        if (!node || depth > targetDepth)
-            return;
-        if (depth == targetDepth || !node->isSplit) {
-            neighbors.push_back(node->id);
-            return;
-        }
-        if (node->isSplit) {
-            for (int i = 0; i < 4; ++i)
-                if (node->children[i])
-                    findNeighborsRecursively(node->children[i], depth + 1);
-        }
-    };
+std::vector<int> Quadtree::getNeighboringCells(int id, Neighborhood neighborhood) const {
+    std::vector<int> neighbors;
+    neighbors.reserve(static_cast<int>(neighborhood));
+    getNeighboringCells(id, neighborhood, neighbors);
+    return neighbors;
+}
 
-    // Attempt to find neighbors in a given direction.
-    std::function<void(Node*, int, int)> findNeighborsInDirection = [&](Node* node, int dx, int dy) {
-        if (!node)
-            return;
-        while (node->parent) {
-            int parentId = node->parent->id;
-            int nodeRow, nodeCol;
-            std::tie(nodeRow, nodeCol) = mortonDecode(node->id);
-            int parentRow, parentCol;
-            std::tie(parentRow, parentCol) = mortonDecode(parentId);
-
-            int depthDiff = getDepth(node->id) - getDepth(parentId);
-
-            if ((nodeRow + dy * pow(2, depthDiff)) >= parentRow &&
-                (nodeRow + dy * pow(2, depthDiff)) < parentRow + pow(2, depthDiff + 1) &&
-                (nodeCol + dx * pow(2, depthDiff)) >= parentCol &&
-                (nodeCol + dx * pow(2, depthDiff)) < parentCol + pow(2, depthDiff)) {
-                Node* neighbor = nullptr;
-                int childIndex;
-                if (dx == 0 && dy == -1)         childIndex = (node == node->parent->children[2]) ? 0 : 1;
-                else if (dx == 1 && dy == -1)    childIndex = 2;
-                else if (dx == 1 && dy == 0)     childIndex = (node == node->parent->children[0]) ? 1 : 3;
-                else if (dx == 1 && dy == 1)     childIndex = 0;
-                else if (dx == 0 && dy == 1)     childIndex = (node == node->parent->children[0]) ? 2 : 3;
-                else if (dx == -1 && dy == 1)    childIndex = 1;
-                else if (dx == -1 && dy == 0)    childIndex = (node == node->parent->children[1]) ? 0 : 2;
-                else if (dx == -1 && dy == -1)   childIndex = 3;
-                neighbor = node->parent->children[childIndex];
-
-                if (neighbor)
-                    findNeighborsRecursively(neighbor, getDepth(neighbor->id));
-                break;
-            }
-            node = node->parent;
-        }
-    };
+void Quadtree::getNeighboringCells(int id, Neighborhood neighborhood, std::vector<int>& neighbors) const {
+    neighbors.clear();
+    if (nodeMap.find(id) == nodeMap.end()) {
+        ERROR_MSG("Error: Target cell " << id << " for neighbor search not found.");
+        return;
+    }
 
-    int dx[] = {0, 1, 1, 0, -1, -1, -1, 0};
-    int dy[] = {-1, -1, 0, 1, 1, 1, 0, -1};
+    // Edge neighbours first, then the diagonals for the 8-neighbourhood
+    static const int dx[] = {0, 1, 0, -1, 1, 1, -1, -1};
+    static const int dy[] = {-1, 0, 1, 0, -1, 1, 1, -1};
+    int numDirections = static_cast<int>(neighborhood);
 
-    for (int i = 0; i < 8; ++i)
-        findNeighborsInDirection(targetNode, dx[i], dy[i]);
+    for (int i = 0; i < numDirections; ++i) {
+        int neighborId = getNeighborCell(id, dx[i], dy[i]);
 
-    std::sort(neighbors.begin(), neighbors.end());
-    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
-    return neighbors;
+        // Coarser neighbours can be shared by several directions
+        if (neighborId >= 0 && std::find(neighbors.begin(), neighbors.end(), neighborId) == neighbors.end())
+            neighbors.push_back(neighborId);
+    }
 }
 
-int Quadtree::getNearestCell(sf::Vector2f position) {
+int Quadtree::getNearestCell(sim::Vector2f position) {
     // Find which base cell contains the position.
-    sf::Vector2f relativePos = position - origin;
+    sim::Vector2f relativePos = position - origin;
     int col = static_cast<int>(relativePos.x / cellSize);
     int row = static_cast<int>(relativePos.y / cellSize);
     col = std::max(0, std::min(col, 1));
@@ -416,9 +286,9 @@ int Quadtree::getNearestCell(sf::Vector2f position) {
     return currentNode->id;
 }
 // TO-DO: Don't make cell when position is outside the grid!!
-int Quadtree::makeCell(sf::Vector2f position) {
+int Quadtree::makeCell(sim::Vector2f position) {
     float currentCellSize = cellSize * 2.0f; // Root cell size
-    sf::Vector2f currentCenter(origin.x + currentCellSize / 2, origin.y + currentCellSize / 2);
+    sim::Vector2f currentCenter(origin.x + currentCellSize / 2, origin.y + currentCellSize / 2);
     int cellID = 0b11; // Start with root cell ID (3)
 
     for (int i = 0; i < maxDepth; ++i) {
@@ -442,15 +312,17 @@ int Quadtree::makeCell(sf::Vector2f position) {
 }
 
 std::vector<int> Quadtree::getSplitSequence(int cellID) {
+    // Cells above maxDepth (e.g. privacy-constrained leaves) use their own depth.
+    int depth = getDepth(cellID);
     std::vector<int> splitSequence;
-    for (int i = 0; i < maxDepth - 1; ++i)
-        splitSequence.push_back((cellID >> (2 * (maxDepth - i - 1))) & 3);
+    for (int i = 0; i < depth - 1; ++i)
+        splitSequence.push_back((cellID >> (2 * (depth - i - 1))) & 3);
     return splitSequence;
 }
 
-std::vector<std::vector<int>> Quadtree::getSplitSequences(const std::vector<sf::Vector2f>& positions) {
+std::vector<std::vector<int>> Quadtree::getSplitSequences(const std::vector<sim::Vector2f>& positions) {
     std::vector<std::vector<int>> splitSequences;
-    std::unordered_map<sf::Vector2f, int, Vector2fHash> positionToCellID;
+    std::unordered_map<sim::Vector2f, int, Vector2fHash> positionToCellID;
 
     for (const auto& pos : positions) {
         // Check if the position is within the grid bounds.
@@ -496,6 +368,11 @@ void Quadtree::splitFromPositions() {
 void Quadtree::splitFromCellIds(std::unordered_set<int> cellIds) {
 
     for (const auto& cellId: cellIds) {
+
+        // Base cells exist already and need no split
+        if (getDepth(cellId) <= 1)
+            continue;
+
         auto splitSequence = getSplitSequence(cellId);
         // std::cout << "Split sequence for cell " << cellId << ": ";
         // for (const auto& morton : splitSequence) {
@@ -518,7 +395,7 @@ void Quadtree::generatePositions(int number) {
     std::mt19937 gen(rd());
     std::uniform_real_distribution<> dis(0.0, cellSize);
     for (int i = 0; i < number; ++i)
-        positions.push_back(sf::Vector2f(dis(gen), dis(gen)));
+        positions.push_back(sim::Vector2f(dis(gen), dis(gen)));
 }
 
 void Quadtree::movePositionsRight(float x) {
@@ -531,7 +408,7 @@ void Quadtree::movePositionsRight(float x) {
 
 // void Quadtree::updateCell() {
 //     // Placeholder for update logic.
-//     for (sf::Vector2f position : positions) {
+//     for (sim::Vector2f position : positions) {
 //         int cellId = getNearestCell(position);
 //         Node* targetNode = getNodeById(cellId);
 //         // (Update logic can be added here.)
@@ -590,13 +467,7 @@ int Quadtree::addAgent(Agent* agent) {
 // ========================
 
 int Quadtree::getDepth(int id) const {
-    int tempId = id;
-    int depth = 0;
-    while (tempId > 0) {
-        tempId >>= 2;
-        ++depth;
-    }
-    return depth - 1; // Base cells are depth 1.
+    return Morton::depth(static_cast<uint32_t>(id)); // Base cells are depth 1.
 }
 
 int Quadtree::mortonEncode(int row, int col) const {
@@ -637,7 +508,7 @@ void Quadtree::splitRecursive(Node* node, const std::vector<int>& path, int path
 // Vector2fHash Implementation
 // ========================
 
-std::size_t Quadtree::Vector2fHash::operator()(const sf::Vector2f& v) const {
+std::size_t Quadtree::Vector2fHash::operator()(const sim::Vector2f& v) const {
     std::size_t h1 = std::hash<float>()(v.x);
     std::size_t h2 = std::hash<float>()(v.y);
     return h1 ^ (h2 << 1);
@@ -0,0 +1,127 @@
+#include <SFML/Graphics.hpp>
+
+#include "../include/Quadtree.hpp"
+
+// Quadtree drawing, compiled into the GUI executable only so that the simulation
+// core does not depend on SFML
+
+// ========================
+// Drawing Functions
+// ========================
+
+void Quadtree::Node::draw(sf::RenderWindow& window, sf::Font& font) {
+    sf::RectangleShape shape;
+    shape.setSize(sf::Vector2f(bounds.size.x, bounds.size.y));
+    shape.setPosition({bounds.position.x, bounds.position.y});
+    shape.setFillColor(sf::Color::Transparent);
+    shape.setOutlineThickness(1);
+    shape.setOutlineColor(sf::Color::Black);
+
+    window.draw(shape);
+    bool drawText = false;
+
+    if(drawText){
+        sf::Text text(font, "", 24);
+        text.setFont(font);
+        text.setString(std::to_string(id));
+        text.setCharacterSize(9);
+        text.setFillColor(sf::Color::Black);
+
+        sf::FloatRect textBounds = text.getLocalBounds();
+        text.setPosition({
+            bounds.position.x + bounds.size.x / 2 - textBounds.size.x / 2,
+            bounds.position.y + bounds.size.y / 2 - textBounds.size.y / 2
+        });
+        window.draw(text);
+    }
+
+    // **Recursively draw children if the node is split**
+    if (isSplit) {
+        for (int i = 0; i < 4; ++i) {
+            if (children[i])
+                children[i]->draw(window, font);
+        }
+    }
+}
+
+void Quadtree::Node::draw(sf::RenderWindow& window, sf::Font& font, float scale, const sim::Vector2f& offset, bool showCellId) {
+    sf::RectangleShape shape;
+    // Scale the size and offset the position
+    shape.setSize(sf::Vector2f(bounds.size.x * scale, bounds.size.y * scale));
+    shape.setPosition({bounds.position.x * scale + offset.x, bounds.position.y * scale + offset.y});
+    shape.setFillColor(sf::Color::Transparent);
+    shape.setOutlineThickness(1);
+    shape.setOutlineColor(sf::Color::Black);
+    window.draw(shape);
+    
+    // Draw the node id text (also apply scaling and offset)
+    if(this->showCellId){
+        sf::Text text(font, std::to_string(id), 0.5 * scale); // Initialize text with font, string and character size
+        text.setFillColor(sf::Color::Black);
+        sf::FloatRect textBounds = text.getLocalBounds();
+        text.setPosition({
+            bounds.position.x * scale + offset.x + (bounds.size.x * scale - textBounds.size.x) / 2,
+            bounds.position.y * scale + offset.y + (bounds.size.y * scale - textBounds.size.y) / 2
+        });
+        window.draw(text);
+    }
+
+    // Recursively draw children nodes
+    if (isSplit) {
+        for (int i = 0; i < 4; ++i) {
+            if (children[i])
+            // children[i]->drawText = false;
+            children[i]->draw(window, font, scale, offset, showCellId);
+        }
+    }
+}
+
+void Quadtree::Node::draw(sf::RenderWindow& window, sf::Font& font, float scale, const sim::Vector2f& offset) {
+    sf::RectangleShape shape;
+    // Scale the size and offset the position
+    shape.setSize(sf::Vector2f(bounds.size.x * scale, bounds.size.y * scale));
+    shape.setPosition({bounds.position.x * scale + offset.x, bounds.position.y * scale + offset.y});
+    shape.setFillColor(sf::Color::Transparent);
+    shape.setOutlineThickness(1);
+    shape.setOutlineColor(sf::Color::Black);
+    window.draw(shape);
+    
+    // Draw the node id text (also apply scaling and offset)
+    if(showCellId){
+        sf::Text text(font, std::to_string(id), 0.5 * scale); // Initialize text with font, string and character size
+        text.setFillColor(sf::Color::Black);
+        sf::FloatRect textBounds = text.getLocalBounds();
+        text.setPosition({
+            bounds.position.x * scale + offset.x + (bounds.size.x * scale - textBounds.size.x) / 2,
+            bounds.position.y * scale + offset.y + (bounds.size.y * scale - textBounds.size.y) / 2
+        });
+        window.draw(text);
+    }
+
+    // Recursively draw children nodes
+    if (isSplit) {
+        for (int i = 0; i < 4; ++i) {
+            if (children[i])
+            // children[i]->drawText = false;
+            children[i]->draw(window, font, scale, offset);
+        }
+    }
+}
+
+void Quadtree::draw(sf::RenderWindow& window, sf::Font& font, float scale, const sim::Vector2f& offset) {
+    for (Node* n : baseNodes){
+        n->draw(window, font, scale, offset, showCellId);
+    }
+}
+
+void Quadtree::drawPositions(sf::RenderWindow& window, const std::vector<sim::Vector2f>& positions) {
+    float circleSize = 4;
+    sf::CircleShape circle(circleSize);
+    circle.setFillColor(sf::Color::Red);
+    for (const sim::Vector2f& pos : positions) {
+        sf::Vector2f newPos = sf::Vector2f(pos.x, pos.y);
+        newPos -= sf::Vector2f(circleSize, circleSize);
+        circle.setPosition(newPos);
+        window.draw(circle);
+    }
+}
@@ -2,7 +2,7 @@
 
 namespace QuadtreeSnapshot {
 
-Node::Node(sf::FloatRect bounds) : bounds(bounds), isSplit(false) {
+Node::Node(sim::FloatRect bounds) : bounds(bounds), isSplit(false) {
     children.fill(nullptr); // Initialize children to nullptr
 }
 
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "../include/RegionIndex.hpp"
+
+// Rasterize the regions into region set ids
+void RegionIndex::build(const std::vector<Region>& regions, sim::Vector2f size, float resolution) {
+
+    this->resolution = resolution;
+    columns = std::max(1, static_cast<int>(std::ceil(size.x / resolution)));
+    rows = std::max(1, static_cast<int>(std::ceil(size.y / resolution)));
+    raster.assign(static_cast<size_t>(columns) * rows, 0);
+
+    // Add every region to the raster cells whose center it contains
+    for (int regionIndex = 0; regionIndex < static_cast<int>(regions.size()); ++regionIndex) {
+        const sim::FloatRect& area = regions[regionIndex].area;
+        int column0 = std::max(0, static_cast<int>(std::ceil(area.position.x / resolution - 0.5f)));
+        int row0 = std::max(0, static_cast<int>(std::ceil(area.position.y / resolution - 0.5f)));
+        int column1 = std::min(columns, static_cast<int>(std::ceil((area.position.x + area.size.x) / resolution - 0.5f)));
+        int row1 = std::min(rows, static_cast<int>(std::ceil((area.position.y + area.size.y) / resolution - 0.5f)));
+
+        for (int row = row0; row < row1; ++row) {
+            for (int column = column0; column < column1; ++column) {
+                int& regionSet = raster[static_cast<size_t>(row) * columns + column];
+                regionSet = addToRegionSet(regionSet, regionIndex);
+            }
+        }
+    }
+
+    DEBUG_MSG("Region index: " << columns << "x" << rows << " cells, " << regionSets.size() << " region sets");
+}
+
+// Region set at a position (O(1))
+int RegionIndex::getRegionSet(sim::Vector2f position) const {
+
+    int column = static_cast<int>(std::floor(position.x / resolution));
+    int row = static_cast<int>(std::floor(position.y / resolution));
+    if (column < 0 || row < 0 || column >= columns || row >= rows) {
+        return 0;
+    }
+
+    return raster[static_cast<size_t>(row) * columns + column];
+}
+
+// Region set and mixed flag of all raster cells overlapping an area
+RegionIndex::Cover RegionIndex::getCover(const sim::FloatRect& area) {
+
+    // Raster cells touched by the area (with a tolerance for edges on cell borders)
+    Cover cover;
+    constexpr float tolerance = 1e-4f;
+    int column0 = static_cast<int>(std::floor(area.position.x / resolution + tolerance));
+    int row0 = static_cast<int>(std::floor(area.position.y / resolution + tolerance));
+    int column1 = static_cast<int>(std::ceil((area.position.x + area.size.x) / resolution - tolerance));
+    int row1 = static_cast<int>(std::ceil((area.position.y + area.size.y) / resolution - tolerance));
+
+    // Parts outside of the raster are not covered by any region
+    bool outside = column0 < 0 || row0 < 0 || column1 > columns || row1 > rows;
+    column0 = std::max(column0, 0);
+    row0 = std::max(row0, 0);
+    column1 = std::min(column1, columns);
+    row1 = std::min(row1, rows);
+
+    bool first = !outside;
+    for (int row = row0; row < row1; ++row) {
+        for (int column = column0; column < column1; ++column) {
+            int regionSet = raster[static_cast<size_t>(row) * columns + column];
+            if (first) {
+                cover.regionSet = regionSet;
+                first = false;
+            } else if (regionSet != cover.regionSet) {
+                cover.regionSet = mergeRegionSets(cover.regionSet, regionSet);
+                cover.mixed = true;
+            }
+        }
+    }
+    cover.mixed = cover.mixed || (outside && cover.regionSet != 0);
+
+    return cover;
+}
+
+// Morton-indexed covers of a quadtree, leaves from the raster and parents from their children
+RegionIndex::CellTable RegionIndex::buildCellTable(const Quadtree& quadtree) {
+
+    CellTable table;
+    table.tableDepth = std::min(quadtree.maxDepth, maxTableDepth);
+    table.covers.assign(size_t{4} << (2 * table.tableDepth), Cover{});
+
+    // Leaves at the table depth
+    uint32_t numLeaves = 1u << (2 * table.tableDepth);
+    for (uint32_t code = 0; code < numLeaves; ++code) {
+        uint32_t id = Morton::attach(code, table.tableDepth);
+        table.covers[id] = getCover(quadtree.getCellBounds(id));
+    }
+
+    // Parents from their four children, up to the base cells
+    for (int depth = table.tableDepth - 1; depth >= 1; --depth) {
+        uint32_t numNodes = 1u << (2 * depth);
+        for (uint32_t code = 0; code < numNodes; ++code) {
+            uint32_t id = Morton::attach(code, depth);
+            Cover& cover = table.covers[id];
+            cover = table.covers[id << 2];
+            for (uint32_t childIndex = 1; childIndex < 4; ++childIndex) {
+                const Cover& child = table.covers[(id << 2) | childIndex];
+                if (child.regionSet != cover.regionSet) {
+                    cover.regionSet = mergeRegionSets(cover.regionSet, child.regionSet);
+                    cover.mixed = true;
+                }
+                cover.mixed = cover.mixed || child.mixed;
+            }
+        }
+    }
+
+    return table;
+}
+
+// Cover of a cell, cells below the table depth use their ancestor's cover (a superset if mixed)
+RegionIndex::Cover RegionIndex::CellTable::getCover(int cellId) const {
+
+    int depth = Morton::depth(cellId);
+    if (depth < 1 || covers.empty()) {
+        return Cover{};
+    }
+    if (depth > tableDepth) {
+        cellId = Morton::ancestor(cellId, depth, tableDepth);
+    }
+
+    return covers[cellId];
+}
+
+// Region set with one more region
+int RegionIndex::addToRegionSet(int regionSet, int regionIndex) {
+
+    std::vector<int> regionList = regionSets[regionSet];
+    regionList.insert(std::lower_bound(regionList.begin(), regionList.end(), regionIndex), regionIndex);
+
+    return getRegionSetId(regionList);
+}
+
+// Union of two region sets (memoized)
+int RegionIndex::mergeRegionSets(int regionSetA, int regionSetB) {
+
+    if (regionSetA == regionSetB || regionSetB == 0) return regionSetA;
+    if (regionSetA == 0) return regionSetB;
+
+    std::pair<int, int> key = std::minmax(regionSetA, regionSetB);
+    auto it = mergedRegionSets.find(key);
+    if (it != mergedRegionSets.end()) {
+        return it->second;
+    }
+
+    std::vector<int> regionList;
+    std::set_union(regionSets[regionSetA].begin(), regionSets[regionSetA].end(),
+                   regionSets[regionSetB].begin(), regionSets[regionSetB].end(),
+                   std::back_inserter(regionList));
+
+    int merged = getRegionSetId(regionList);
+    mergedRegionSets.emplace(key, merged);
+
+    return merged;
+}
+
+// Id of a sorted region list, adding a new set if needed
+int RegionIndex::getRegionSetId(const std::vector<int>& regionList) {
+
+    if (regionList.empty()) {
+        return 0;
+    }
+
+    auto [it, inserted] = regionSetIds.try_emplace(regionList, static_cast<int>(regionSets.size()));
+    if (inserted) {
+        regionSets.push_back(regionList);
+    }
+
+    return it->second;
+}
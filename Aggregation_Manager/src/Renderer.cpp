@@ -130,13 +130,20 @@ void Renderer::loadObstacles() {
             std::string type = obstacleNode["type"] && obstacleNode["type"].IsScalar()
                 ? obstacleNode["type"].as<std::string>() : "unknown";
 
-            if (type == "rectangle") { // Only handle rectangles
+            if (type == "rectangle") {
                 std::vector<float> position = obstacleNode["position"].as<std::vector<float>>();
                 std::vector<float> size = obstacleNode["size"].as<std::vector<float>>();
                 obstacles.push_back(Obstacle(
                     sf::FloatRect({position[0], position[1]}, {size[0], size[1]}), 
                     stringToColor(obstacleNode["color"].as<std::string>())
                 ));
+            } else if (type == "polygon") {
+                std::vector<sim::Vector2f> vertices;
+                for (const auto& vertex : obstacleNode["vertices"]) {
+                    std::vector<float> point = vertex.as<std::vector<float>>();
+                    vertices.emplace_back(point[0], point[1]);
+                }
+                obstacles.push_back(Obstacle(std::move(vertices), stringToColor(obstacleNode["color"].as<std::string>())));
             } else {
                 ERROR_MSG("Error: Unknown obstacle type in config file at position " << i);
             }
@@ -655,6 +662,9 @@ void Renderer::run() {
             lastMousePosition = currentMousePosition;
         }
 
+        // Publish the visible area in meters, the simulation updates the agents in view at full detail
+        agentBuffer.setViewport(sim::FloatRect({-offset.x / scale, -offset.y / scale}, {windowWidth / scale, windowHeight / scale}));
+
         // Get the time taken to handle events
         eventHandlingTime = rendererFrameClock.getElapsedTime().asSeconds();
 
@@ -1066,6 +1076,20 @@ void Renderer::render() {  // Input: meters, Output: pixels
 
             // Draw obstacles
             for (const Obstacle& obstacle : obstacles) {
+
+                // Polygons as outlines (footprints may be concave)
+                if (obstacle.isPolygon()) {
+                    const std::vector<sim::Vector2f>& vertices = obstacle.getVertices();
+                    sf::VertexArray outline(sf::PrimitiveType::Lines);
+                    for (size_t i = 0; i < vertices.size(); ++i) {
+                        const sim::Vector2f& from = vertices[i];
+                        const sim::Vector2f& to = vertices[(i + 1) % vertices.size()];
+                        outline.append(sf::Vertex({sf::Vector2f(from.x * scale, from.y * scale) + offset, obstacle.getColor()}));
+                        outline.append(sf::Vertex({sf::Vector2f(to.x * scale, to.y * scale) + offset, obstacle.getColor()}));
+                    }
+                    window.draw(outline);
+                    continue;
+                }
                 
                 sf::RectangleShape obstacleShape(sf::Vector2f(obstacle.getBounds().size.x * scale, obstacle.getBounds().size.y * scale));
                 obstacleShape.setPosition({obstacle.getBounds().position.x * scale + offset.x, obstacle.getBounds().position.y * scale + offset.y}); // Scale only position here
@@ -1104,31 +1128,18 @@ void Renderer::render() {  // Input: meters, Output: pixels
             agent.waypointDistance = currentAgent.waypointDistance * scale; // Pixels
             agent.nextWaypointIndex = currentAgent.nextWaypointIndex;
 
-            for(auto& waypoint : currentAgent.trajectory) {
-                agent.trajectory.push_back(waypoint * scale);
-            }
-
             // Determine the next waypoint index that is ahead of the agent
             if(showWaypoints) {
                 
                 sf::VertexArray waypoints(sf::PrimitiveType::Triangles, 6);
 
-                // Calculate the next waypoint
-                // Get the next waypoint based on trajectory, position, and velocity
-                for (int i = 0; i < agent.trajectory.size(); ++i) {
-                    sf::Vector2f directionToWaypoint = agent.trajectory[i] - agent.position;
-                    float dotProduct = directionToWaypoint.x * agent.velocity.x + directionToWaypoint.y * agent.velocity.y;
-                    if (dotProduct > 0) {
-                        agent.nextWaypointIndex = i;
-                        break;
-                    }
-                }
-                // agent.getNextWaypoint();
+                // Get the next waypoint based on trajectory, position, and velocity (in meters, scaling keeps the order)
+                agent.nextWaypointIndex = currentAgent.trajectory.getNextWaypointIndex(currentAgent.position, currentAgent.velocity);
 
                 // Calculate the neighboring pixels for the quad
                 if (agent.nextWaypointIndex != -1) {
-                    for (size_t i = agent.nextWaypointIndex; i < agent.trajectory.size(); ++i) {
-                        sf::Vector2f center = agent.trajectory[i];
+                    for (size_t i = agent.nextWaypointIndex; i < currentAgent.trajectory.size(); ++i) {
+                        sf::Vector2f center = currentAgent.trajectory[i] * scale; // Pixels
                         sf::Color color = agent.waypointColor;
 
                         // Calculate quad vertices
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include "../include/RollupCube.hpp"
+
+// Add the counts of one cell for one sensor frame to the cell and all its ancestors
+void RollupCube::add(int cellId, std::chrono::system_clock::time_point timestamp, const std::unordered_map<std::string, int>& agentTypeCount, int totalAgents) {
+
+    int64_t time = toMilliseconds(timestamp);
+
+    // Resolve the type indices once for all ancestors
+    typeCounts.clear();
+    for (const auto& [agentType, count] : agentTypeCount) {
+        int typeIndex = getTypeIndex(agentType);
+        if (typeIndex >= 0) {
+            typeCounts.emplace_back(typeIndex, count);
+        }
+    }
+
+    // Walk up to the root (0b11), each step removes one Morton digit
+    for (uint32_t nodeId = static_cast<uint32_t>(cellId); nodeId >= 0b11u; nodeId >>= 2) {
+        for (const auto& [typeIndex, count] : typeCounts) {
+            series[makeKey(nodeId, typeIndex)].add(time, count);
+        }
+        series[makeKey(nodeId, totalIndex)].add(time, totalAgents);
+    }
+}
+
+// Counts per agent type of a node within [start, end)
+std::unordered_map<std::string, int64_t> RollupCube::query(int cellId, std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end) const {
+
+    std::unordered_map<std::string, int64_t> counts;
+    int64_t startTime = toMilliseconds(start);
+    int64_t endTime = toMilliseconds(end);
+
+    for (size_t typeIndex = 0; typeIndex < agentTypes.size(); ++typeIndex) {
+        auto it = series.find(makeKey(cellId, static_cast<int>(typeIndex)));
+        if (it != series.end()) {
+            int64_t count = it->second.sum(startTime, endTime);
+            if (count > 0) {
+                counts[agentTypes[typeIndex]] = count;
+            }
+        }
+    }
+
+    return counts;
+}
+
+// Total count of a node within [start, end)
+int64_t RollupCube::queryTotal(int cellId, std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end) const {
+
+    auto it = series.find(makeKey(cellId, totalIndex));
+    if (it == series.end()) {
+        return 0;
+    }
+
+    return it->second.sum(toMilliseconds(start), toMilliseconds(end));
+}
+
+// Write the agent types and all series to a binary file
+bool RollupCube::save(const std::string& path) const {
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        ERROR_MSG("Error: Could not open roll-up output " << path);
+        return false;
+    }
+
+    // Header: magic, version and agent types
+    file.write("RLUP", 4);
+    file.write(reinterpret_cast<const char*>(&fileVersion), sizeof(fileVersion));
+    uint32_t numTypes = static_cast<uint32_t>(agentTypes.size());
+    file.write(reinterpret_cast<const char*>(&numTypes), sizeof(numTypes));
+    for (const std::string& agentType : agentTypes) {
+        uint32_t length = static_cast<uint32_t>(agentType.size());
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(agentType.data(), length);
+    }
+
+    // Series sorted by key, i.e. in Morton order of the cells
+    std::vector<uint64_t> keys;
+    keys.reserve(series.size());
+    for (const auto& [key, nodeSeries] : series) {
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    uint64_t numSeries = keys.size();
+    file.write(reinterpret_cast<const char*>(&numSeries), sizeof(numSeries));
+    for (uint64_t key : keys) {
+        const Series& nodeSeries = series.at(key);
+        uint64_t numEntries = nodeSeries.times.size();
+        file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        file.write(reinterpret_cast<const char*>(&numEntries), sizeof(numEntries));
+        file.write(reinterpret_cast<const char*>(nodeSeries.times.data()), numEntries * sizeof(int64_t));
+        file.write(reinterpret_cast<const char*>(nodeSeries.prefixSums.data()), numEntries * sizeof(int64_t));
+    }
+
+    return static_cast<bool>(file);
+}
+
+// Read a roll-up written by save, replacing the current contents
+bool RollupCube::load(const std::string& path) {
+
+    std::ifstream file(path, std::ios::binary);
+    char magic[4];
+    uint32_t version = 0;
+    if (!file.read(magic, 4) || std::string(magic, 4) != "RLUP" ||
+        !file.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != fileVersion) {
+        ERROR_MSG("Error: " << path << " is not a roll-up file of version " << fileVersion);
+        return false;
+    }
+
+    clear();
+
+    // Agent types
+    uint32_t numTypes = 0;
+    file.read(reinterpret_cast<char*>(&numTypes), sizeof(numTypes));
+    for (uint32_t i = 0; i < numTypes && file; ++i) {
+        uint32_t length = 0;
+        file.read(reinterpret_cast<char*>(&length), sizeof(length));
+        std::string agentType(length, '\0');
+        file.read(agentType.data(), length);
+        getTypeIndex(agentType);
+    }
+
+    // Series
+    uint64_t numSeries = 0;
+    file.read(reinterpret_cast<char*>(&numSeries), sizeof(numSeries));
+    for (uint64_t i = 0; i < numSeries && file; ++i) {
+        uint64_t key = 0, numEntries = 0;
+        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+        file.read(reinterpret_cast<char*>(&numEntries), sizeof(numEntries));
+        Series& nodeSeries = series[key];
+        nodeSeries.times.resize(numEntries);
+        nodeSeries.prefixSums.resize(numEntries);
+        file.read(reinterpret_cast<char*>(nodeSeries.times.data()), numEntries * sizeof(int64_t));
+        file.read(reinterpret_cast<char*>(nodeSeries.prefixSums.data()), numEntries * sizeof(int64_t));
+    }
+
+    if (!file) {
+        ERROR_MSG("Error: Truncated roll-up file " << path);
+        clear();
+        return false;
+    }
+
+    return true;
+}
+
+void RollupCube::clear() {
+    series.clear();
+    agentTypes.clear();
+    agentTypeIndices.clear();
+}
+
+// Append a count, merging counts of the same timestamp
+void RollupCube::Series::add(int64_t time, int64_t count) {
+
+    if (!times.empty() && times.back() == time) {
+        prefixSums.back() += count;
+        return;
+    }
+
+    times.push_back(time);
+    prefixSums.push_back((prefixSums.empty() ? 0 : prefixSums.back()) + count);
+}
+
+// Sum of the counts within [start, end)
+int64_t RollupCube::Series::sum(int64_t start, int64_t end) const {
+
+    if (start >= end) {
+        return 0;
+    }
+
+    size_t first = std::lower_bound(times.begin(), times.end(), start) - times.begin();
+    size_t last = std::lower_bound(times.begin(), times.end(), end) - times.begin();
+
+    int64_t before = first > 0 ? prefixSums[first - 1] : 0;
+    int64_t upTo = last > 0 ? prefixSums[last - 1] : 0;
+
+    return upTo - before;
+}
+
+int64_t RollupCube::toMilliseconds(std::chrono::system_clock::time_point timestamp) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
+}
+
+// Index of an agent type, -1 if there are too many (0xFF is reserved for the totals)
+int RollupCube::getTypeIndex(const std::string& agentType) {
+
+    auto it = agentTypeIndices.find(agentType);
+    if (it == agentTypeIndices.end()) {
+        if (agentTypes.size() >= totalIndex) {
+            ERROR_MSG("Error: Too many agent types for the roll-up, ignoring " << agentType);
+            return -1;
+        }
+        it = agentTypeIndices.emplace(agentType, static_cast<int>(agentTypes.size())).first;
+        agentTypes.push_back(agentType);
+    }
+
+    return it->second;
+}
@@ -0,0 +1,128 @@
+#include "../include/ScenarioData.hpp"
+#include "../include/Logging.hpp"
+#include "../include/Utilities.hpp"
+
+// Parse the taxonomies and obstacles of a configuration
+std::shared_ptr<const ScenarioData> ScenarioData::load(const YAML::Node& config) {
+
+    auto data = std::make_shared<ScenarioData>();
+    data->loadAgentsAttributes(config);
+    data->loadRegionsAttributes(config);
+    data->loadObstacles(config);
+
+    return data;
+}
+
+void ScenarioData::loadAgentsAttributes(const YAML::Node& config) {
+
+    // Extract agent attributes per type
+    if (config["agents"] && config["agents"]["road_user_taxonomy"]) {
+        for (const auto& agentType : config["agents"]["road_user_taxonomy"]) {
+            std::string type = agentType["type"].as<std::string>();
+            Agent::AgentTypeAttributes attributes;
+
+            attributes.probability = agentType["probability"].as<double>();
+            attributes.priority = agentType["priority"].as<int>();
+            attributes.bodyRadius = agentType["radius"].as<double>();
+            attributes.color = agentType["color"].as<std::string>();
+
+            attributes.velocity.min = agentType["velocity"]["min"].as<double>();
+            attributes.velocity.max = agentType["velocity"]["max"].as<double>();
+            attributes.velocity.mu = agentType["velocity"]["mu"].as<double>();
+            attributes.velocity.sigma = agentType["velocity"]["sigma"].as<double>();
+            attributes.velocity.noiseScale = agentType["velocity"]["noise_scale"].as<double>();
+            attributes.velocity.noiseFactor = agentType["velocity"]["noise_factor"].as<double>();
+
+            attributes.acceleration.min = agentType["acceleration"]["min"].as<double>();
+            attributes.acceleration.max = agentType["acceleration"]["max"].as<double>();
+
+            attributes.lookAheadTime = agentType["look_ahead_time"].as<double>();
+
+            // Arrival rate in the continuous scenario
+            if (agentType["spawn_rate"]) {
+                attributes.spawnRate = agentType["spawn_rate"].as<double>();
+            }
+
+            // Store in map
+            agentTypeAttributes[type] = attributes;
+        }
+    }
+}
+
+void ScenarioData::loadRegionsAttributes(const YAML::Node& config) {
+
+    // Extract region atributes per type
+    if (config["region_taxonomy"]) {
+        for (const auto& regionType : config["region_taxonomy"]) {
+            Region::RegionTypeAttributes attributes;
+            std::string type = regionType["type"].as<std::string>();
+
+            // General attributes
+            attributes.color = regionType["color"].as<std::string>();
+            attributes.alpha = regionType["alpha"].as<float>();
+            // Granularities
+            attributes.granularities.spatial.min = regionType["granularities"]["spatial"]["min"].as<float>();
+            attributes.granularities.spatial.max = regionType["granularities"]["spatial"]["max"].as<float>();
+            attributes.granularities.temporal.min = regionType["granularities"]["temporal"]["min"].as<float>();
+            attributes.granularities.temporal.max = regionType["granularities"]["temporal"]["max"].as<float>();
+            // Privacy
+            attributes.privacy.k_anonymity.min = regionType["privacy"]["k_anonymity"]["min"].as<int>();
+            attributes.privacy.l_diversity.min = regionType["privacy"]["l_diversity"]["min"].as<int>();
+
+            // Store in map
+            regionTypeAttributes[type] = attributes;
+        }
+    }
+}
+
+// Function to load obstacles from the YAML configuration file
+void ScenarioData::loadObstacles(const YAML::Node& config) {
+
+    // Check if the 'obstacles' key exists and is a sequence
+    if (config["obstacles"] && config["obstacles"].IsSequence()) {
+        for (const auto& obstacleNode : config["obstacles"]) {
+            std::string type = obstacleNode["type"] && obstacleNode["type"].IsScalar()
+                ? obstacleNode["type"].as<std::string>()
+                : "unknown";
+
+            if (type == "rectangle") {
+                std::vector<float> position = obstacleNode["position"].as<std::vector<float>>();
+                std::vector<float> size = obstacleNode["size"].as<std::vector<float>>();
+                obstacles.push_back(Obstacle(
+                    sim::FloatRect({position[0], position[1]}, {size[0], size[1]}), 
+                    stringToColor(obstacleNode["color"].as<std::string>())
+                ));
+            } else if (type == "polygon") {
+                std::vector<sim::Vector2f> vertices;
+                for (const auto& vertex : obstacleNode["vertices"]) {
+                    std::vector<float> point = vertex.as<std::vector<float>>();
+                    vertices.emplace_back(point[0], point[1]);
+                }
+                if (vertices.size() < 3) {
+                    ERROR_MSG("Error: Polygon obstacle with " << vertices.size() << " vertices in config file.");
+                    continue;
+                }
+                obstacles.push_back(Obstacle(std::move(vertices), stringToColor(obstacleNode["color"].as<std::string>())));
+            } else {
+                ERROR_MSG("Error: Unknown obstacle type '" << type << "' in config file.");
+            }
+        }
+    } else {
+        ERROR_MSG("Error: Could not find 'obstacles' key in config file or it is not a sequence.");
+    }
+
+    // Spatial index of the obstacles (cell size derived from the obstacles unless set)
+    float cellSize = 0.0f;
+    if (config["collision"] && config["collision"]["obstacle_grid"] && config["collision"]["obstacle_grid"]["cell_size"]) {
+        cellSize = config["collision"]["obstacle_grid"]["cell_size"].as<float>();
+    }
+    obstacleIndex.build(obstacles, cellSize);
+
+    // Signed distance field of the obstacles, if configured
+    if (config["collision"] && config["collision"]["distance_field"]) {
+        const YAML::Node& fieldConfig = config["collision"]["distance_field"];
+        float resolution = fieldConfig["resolution"] ? fieldConfig["resolution"].as<float>() : 0.5f;
+        float maxDistance = fieldConfig["max_distance"] ? fieldConfig["max_distance"].as<float>() : 10.0f;
+        distanceField.build(obstacles, resolution, maxDistance);
+    }
+}
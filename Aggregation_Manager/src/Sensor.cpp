@@ -7,15 +7,15 @@
 #include <uuid/uuid.h>
 
 #include "../include/Sensor.hpp"
+#include "../include/Checkpoint.hpp"
 
 // Base Sensor constructor for simulation
 Sensor::Sensor(
     float frameRate,
-    sf::FloatRect detectionArea,
+    sim::FloatRect detectionArea,
     std::shared_ptr<mongocxx::client> client,
     SharedBuffer<sensorBufferFrameType>& sensorBuffer
 ) : frameRate(frameRate),
-    timeSinceLastUpdate(0.0f),
     client(std::move(client)),
     sensorId(generateUUID()),
     sensorBuffer(sensorBuffer)
@@ -23,29 +23,52 @@ Sensor::Sensor(
 
 // Base Sensor constructor for rendering
 Sensor::Sensor(
-    const sf::FloatRect& detectionArea, 
-    const sf::Color& detectionAreaColor,
+    const sim::FloatRect& detectionArea, 
+    const sim::Color& detectionAreaColor,
     SharedBuffer<sensorBufferFrameType>& sensorBuffer
 ):  detectionArea(detectionArea), 
     detectionAreaColor(detectionAreaColor), 
     sensorBuffer(sensorBuffer) 
 {}
 
+// Update at exact tick multiples of the sensor period
+bool Sensor::isUpdateDue(const SimulationClock& clock) {
+
+    if (updateInterval == 0) {
+        updateInterval = clock.getTicksPerPeriod(frameRate);
+    }
+
+    return clock.getTick() % updateInterval == 0;
+}
+
 // Base Sensor velocity estimation
-void Sensor::estimateVelocities(std::unordered_map<std::string, sf::Vector2f>& estimatedVelocities) {
+void Sensor::estimateVelocities(std::unordered_map<std::string, sim::Vector2f>& estimatedVelocities) {
 
     // Estimate the velocities of the agents
     for (const auto& kvp : previousPositions) {
 
         const std::string& agentUUID = kvp.first;
-        const sf::Vector2f& previousPosition = kvp.second;
+        const sim::Vector2f& previousPosition = kvp.second;
 
         // If the agent is still in the detection area
         if (currentPositions.find(agentUUID) != currentPositions.end()) {
 
-            const sf::Vector2f& currentPosition = currentPositions[agentUUID];
-            sf::Vector2f estimatedVelocity = (currentPosition - previousPosition) * frameRate;
+            const sim::Vector2f& currentPosition = currentPositions[agentUUID];
+            sim::Vector2f estimatedVelocity = (currentPosition - previousPosition) * frameRate;
             estimatedVelocities[agentUUID] = estimatedVelocity;
         }
     }
-}
\ No newline at end of file
+}
+
+// Checkpoint of the state carried between updates (a restored sensor keeps its new id and metadata)
+void Sensor::saveState(CheckpointWriter& writer) const {
+    writer.write(timestamp);
+    writer.write(previousPositions);
+    writer.write(currentPositions);
+}
+
+void Sensor::loadState(CheckpointReader& reader) {
+    reader.read(timestamp);
+    reader.read(previousPositions);
+    reader.read(currentPositions);
+}
@@ -4,39 +4,52 @@
 #include "../include/GridBasedSensor.hpp"
 #include "../include/AdaptiveGridBasedSensor.hpp"
 #include "../include/Region.hpp"
+#include "../include/Checkpoint.hpp"
+#include "../include/CollisionAvoidance.hpp"
 
 // Simulation constructor
 Simulation::Simulation(
     SharedBuffer<agentBufferFrameType>& agentBuffer,
     SharedBuffer<sensorBufferFrameType>& sensorBuffer,
-    std::atomic<float>& currentSimulationTimeStep, const YAML::Node& config)
-: agentBuffer(agentBuffer), sensorBuffer(sensorBuffer), currentSimulationTimeStep(currentSimulationTimeStep), config(config), collisionGrid(0, sf::FloatRect({0.0f, 0.0f}, {0.0f, 0.0f})), instance {} {
+    std::atomic<float>& currentSimulationTimeStep, const YAML::Node& config,
+    std::shared_ptr<const ScenarioData> scenarioData)
+: agentBuffer(agentBuffer), sensorBuffer(sensorBuffer), currentSimulationTimeStep(currentSimulationTimeStep), config(config), scenarioData(std::move(scenarioData)), collisionGrid(0, sim::FloatRect({0.0f, 0.0f}, {0.0f, 0.0f})) {
     
     // Set the initial write agentBuffer (second queue agentBuffer) -> TODO: Make SharedBuffer class and move this logic there
     DEBUG_MSG("Simulation: " << agentBuffer.name << " write buffer " << agentBuffer.writeBufferIndex);
     DEBUG_MSG("Simulation: " << sensorBuffer.name << " write buffer " << sensorBuffer.writeBufferIndex);
     loadConfiguration();
-    loadAgentsAttributes();
-    loadRegionsAttributes();
-    loadObstacles();
+
+    // Parse the taxonomies and obstacles unless they are shared (ensemble runs)
+    if (!this->scenarioData) {
+        this->scenarioData = ScenarioData::load(config);
+    }
+    numAgentTypes = this->scenarioData->agentTypeAttributes.size();
+    numRegionTypes = this->scenarioData->regionTypeAttributes.size();
+
     initializeDatabase();
+    initializeDistributed();
     initializeGrid();
+    initializeTiles();
     initializeAgents();
     initializeRegions();
     initializeSensors();
+
+    // Continue from a checkpoint (agents, random streams, clock and sensor states)
+    if (!checkpointRestore.empty() && !loadCheckpoint(checkpointRestore)) {
+        throw std::runtime_error("Could not restore checkpoint " + checkpointRestore);
+    }
 }
 
 Simulation::~Simulation() {
     
     // Clean up resources
     sensors.clear();
-    obstacles.clear();
     regions.clear();
     agents.clear();
+    agentHandles.clear();
     collisionGrid.clear();
     documentBuffer.clear();
-    agentTypeAttributes.clear();
-    regionTypeAttributes.clear();
 }
 
 void Simulation::loadConfiguration() {
@@ -62,12 +75,32 @@ void Simulation::loadConfiguration() {
     waypointDistance = config["agents"]["waypoint_distance"].as<float>();
     numAgents = config["agents"]["num_agents"].as<int>();
 
-    // Load number of threads -> TODO: Use this to initialize the thread pool (path finding)
-    // if(config["simulation"]["num_threads"].as<int>()) {
-    //     numThreads = config["simulation"]["num_threads"].as<int>();
-    // } else {
-    //     numThreads = std::thread::hardware_concurrency();
-    // }
+    // Seed of all random streams, drawn (and logged for reproduction) if not configured
+    if(config["simulation"]["seed"]) {
+        seed = config["simulation"]["seed"].as<uint64_t>();
+    } else {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+    DEBUG_MSG("Simulation seed: " << seed);
+
+    // Velocity noise type and seed (the simulation seed unless set)
+    PerlinNoise::Type noiseType = PerlinNoise::Type::Perlin;
+    uint64_t noiseSeed = seed;
+    if(config["agents"]["noise"]) {
+        const YAML::Node& noiseConfig = config["agents"]["noise"];
+        if (noiseConfig["type"]) noiseType = PerlinNoise::parseType(noiseConfig["type"].as<std::string>());
+        if (noiseConfig["seed"]) noiseSeed = noiseConfig["seed"].as<uint64_t>();
+    }
+    velocityNoise = PerlinNoise(noiseSeed, noiseType);
+
+    // Load number of threads (agent initialization) -> TODO: Use this for path finding
+    if(config["simulation"]["num_threads"]) {
+        numThreads = config["simulation"]["num_threads"].as<int>();
+    } else {
+        numThreads = std::thread::hardware_concurrency();
+    }
+    numThreads = std::max(numThreads, 1);
 
     // If datetime is provided in the configuration, use it, otherwise use the current time
     if(config["simulation"]["datetime"]) {
@@ -80,12 +113,37 @@ void Simulation::loadConfiguration() {
         datetime = generateISOTimestamp();
     }
 
-    // Set simulation timestamp
-    timestamp = generateISOTimestamp(simulationTime, datetime);
+    // Set simulation clock (the datetime is parsed once) and timestamp
+    clock = SimulationClock(datetime, timeStep);
+    timestamp = clock.getTimestamp();
+
+    // Checkpoints every interval_seconds of simulation time and/or a checkpoint to start from
+    if(config["simulation"]["checkpoint"]) {
+        const YAML::Node& checkpointConfig = config["simulation"]["checkpoint"];
+        if (checkpointConfig["interval_seconds"] && checkpointConfig["interval_seconds"].as<double>() > 0.0) {
+            checkpointInterval = clock.getTicksPerPeriod(1.0 / checkpointConfig["interval_seconds"].as<double>());
+        }
+        if (checkpointConfig["output"]) checkpointOutput = checkpointConfig["output"].as<std::string>();
+        if (checkpointConfig["restore"]) checkpointRestore = checkpointConfig["restore"].as<std::string>();
+    }
 
     // Collision
     collisionGridCellSize = config["collision"]["grid"]["cell_size"].as<float>();
 
+    // Sleeping agents (disabled unless configured)
+    if(config["collision"]["sleep"]) {
+        const YAML::Node& sleepConfig = config["collision"]["sleep"];
+        sleepAfterFrames = sleepConfig["after_frames"] ? std::max(sleepConfig["after_frames"].as<int>(), 0) : 20;
+        maxSleepTicks = sleepConfig["max_frames"] ? std::max(sleepConfig["max_frames"].as<int>(), 1) : 200;
+    }
+
+    // Level of detail (disabled unless configured): agents outside the sensors and the viewport update every interval_frames
+    if(config["simulation"]["level_of_detail"]) {
+        const YAML::Node& lodConfig = config["simulation"]["level_of_detail"];
+        lodInterval = lodConfig["interval_frames"] ? std::max(lodConfig["interval_frames"].as<int>(), 1) : 10;
+        lodMargin = lodConfig["margin"] ? std::max(lodConfig["margin"].as<float>(), 0.0f) : collisionGridCellSize;
+    }
+
     // Scenario
     if(config["simulation"]["scenario"]) {
         scenario = config["simulation"]["scenario"].as<std::string>();
@@ -95,214 +153,191 @@ void Simulation::loadConfiguration() {
     }
 }
 
-void Simulation::loadAgentsAttributes() {
-
-    // Extract agent attributes per type
-    if (config["agents"] && config["agents"]["road_user_taxonomy"]) {
-        for (const auto& agentType : config["agents"]["road_user_taxonomy"]) {
-            std::string type = agentType["type"].as<std::string>();
-            Agent::AgentTypeAttributes attributes;
-
-            attributes.probability = agentType["probability"].as<double>();
-            attributes.priority = agentType["priority"].as<int>();
-            attributes.bodyRadius = agentType["radius"].as<double>();
-            attributes.color = agentType["color"].as<std::string>();
-
-            attributes.velocity.min = agentType["velocity"]["min"].as<double>();
-            attributes.velocity.max = agentType["velocity"]["max"].as<double>();
-            attributes.velocity.mu = agentType["velocity"]["mu"].as<double>();
-            attributes.velocity.sigma = agentType["velocity"]["sigma"].as<double>();
-            attributes.velocity.noiseScale = agentType["velocity"]["noise_scale"].as<double>();
-            attributes.velocity.noiseFactor = agentType["velocity"]["noise_factor"].as<double>();
-
-            attributes.acceleration.min = agentType["acceleration"]["min"].as<double>();
-            attributes.acceleration.max = agentType["acceleration"]["max"].as<double>();
-
-            attributes.lookAheadTime = agentType["look_ahead_time"].as<double>();
-
-            // Store in map
-            agentTypeAttributes[type] = attributes;
-        }
-
-        // Set the number of agent types
-        numAgentTypes = agentTypeAttributes.size();
-    }
-}
-
-void Simulation::loadRegionsAttributes() {
-
-    // Extract region atributes per type
-    if (config["region_taxonomy"]) {
-        for (const auto& regionType : config["region_taxonomy"]) {
-            Region::RegionTypeAttributes attributes;
-            std::string type = regionType["type"].as<std::string>();
-
-            // General attributes
-            attributes.color = regionType["color"].as<std::string>();
-            attributes.alpha = regionType["alpha"].as<float>();
-            // Granularities
-            attributes.granularities.spatial.min = regionType["granularities"]["spatial"]["min"].as<float>();
-            attributes.granularities.spatial.max = regionType["granularities"]["spatial"]["max"].as<float>();
-            attributes.granularities.temporal.min = regionType["granularities"]["temporal"]["min"].as<float>();
-            attributes.granularities.temporal.max = regionType["granularities"]["temporal"]["max"].as<float>();
-            // Privacy
-            attributes.privacy.k_anonymity.min = regionType["privacy"]["k_anonymity"]["min"].as<int>();
-            attributes.privacy.l_diversity.min = regionType["privacy"]["l_diversity"]["min"].as<int>();
-
-            // Store in map
-            regionTypeAttributes[type] = attributes;
-        }
-
-        // Set the number of agent types
-        numRegionTypes = regionTypeAttributes.size();
-    }
-}
-
 // Function to initialize the grid based on the YAML configuration
 void Simulation::initializeGrid() {
 
     // Initialize the grid
     // collisionGrid = Grid(collisionGridCellSize, simulationWidth / collisionGridCellSize, simulationHeight / collisionGridCellSize);
-    collisionGrid = Grid(collisionGridCellSize, sf::FloatRect({0.0f, 0.0f}, {simulationWidth, simulationHeight}));
-}
-
-// Function to load obstacles from the YAML configuration file
-void Simulation::loadObstacles() {
-
-    // Check if the 'obstacles' key exists and is a sequence
-    if (config["obstacles"] && config["obstacles"].IsSequence()) {
-        for (const auto& obstacleNode : config["obstacles"]) {
-            std::string type = obstacleNode["type"] && obstacleNode["type"].IsScalar()
-                ? obstacleNode["type"].as<std::string>()
-                : "unknown";
-
-            if (type == "rectangle") { // Only handle rectangles
-                std::vector<float> position = obstacleNode["position"].as<std::vector<float>>();
-                std::vector<float> size = obstacleNode["size"].as<std::vector<float>>();
-                obstacles.push_back(Obstacle(
-                    sf::FloatRect({position[0], position[1]}, {size[0], size[1]}), 
-                    stringToColor(obstacleNode["color"].as<std::string>())
-                ));
-            } else {
-                ERROR_MSG("Error: Unknown obstacle type '" << type << "' in config file.");
-            }
-        }
-    } else {
-        ERROR_MSG("Error: Could not find 'obstacles' key in config file or it is not a sequence.");
-    }
+    collisionGrid = Grid(collisionGridCellSize, sim::FloatRect({0.0f, 0.0f}, {simulationWidth, simulationHeight}));
 }
 
 void Simulation::initializeAgents() {
 
+    // The population comes from the checkpoint when restoring, only arrivals are set up
+    if (!checkpointRestore.empty()) {
+        if (scenario == "continuous") {
+            initializeSpawning();
+        }
+        return;
+    }
+
     // Initialize agents based on the scenario
     if (scenario == "random") {
 
-        for (int i = 0; i < numAgents; ++i) {
-
-            std::random_device rd;
-            std::mt19937 gen(rd());
-
-            std::uniform_real_distribution<> disPosX(0, simulationWidth);
-            std::uniform_real_distribution<> disPosY(0, simulationHeight);
-
-            Agent agent(agentTypeAttributes["Adult Cyclist"]);
-
-            agent.agentId = generateUUID();
-            agent.sensorId = "0";
-            agent.type = "Adult Cyclist";
-            agent.color = stringToColor(agent.attributes.color);
-            agent.priority = agent.attributes.priority;
-            agent.bodyRadius = agent.attributes.bodyRadius;
-            agent.lookAheadTime = agent.attributes.lookAheadTime;
-
-            agent.setBufferZoneSize();
-            agent.initialPosition = sf::Vector2f(disPosX(gen), disPosY(gen));
-            agent.targetPosition = sf::Vector2f(disPosX(gen), disPosY(gen));
-            agent.position = agent.initialPosition;
-            agent.waypointDistance = waypointDistance; // -> TODO: Use taxonomy for waypoint distance
-            // agent.waypointColor = sf::Color::Red;
-            agent.calculateTrajectory(agent.waypointDistance);
-            agent.timestamp = timestamp; // Use simulation timestamp from initialization
-
-            agent.velocityMagnitude = generateRandomNumberFromTND(
-                agent.attributes.velocity.mu, agent.attributes.velocity.sigma, 
-                agent.attributes.velocity.min, agent.attributes.velocity.max
-            );
-            agent.calculateVelocity(agent.trajectory[1]);
-            agent.initialVelocity = agent.velocity;
-
-            agents.push_back(agent);
-        }
+        // All agents are adult cyclists
+        createAgents({{"Adult Cyclist", numAgents}});
     }
     else if(scenario == "crossing") {
 
     }
     else if(scenario == "continuous") {
 
+        // Agents arrive over time, num_agents caps the population
+        initializeSpawning();
     }
     // Default scenario
     else {
         // Check if sum of probabilities is 1
         double sum = 0;
-        for (const auto& agentType : agentTypeAttributes) {
+        for (const auto& agentType : scenarioData->agentTypeAttributes) {
             sum += agentType.second.probability;
         }
         if (std::abs(sum - 1) > tolerance) {
-            ERROR_MSG("Error: Sum of agent probabilities is not equal to 1, but " << (float)sum);
-            exit(EXIT_FAILURE);
+            throw std::runtime_error("Sum of agent probabilities is not equal to 1, but " + std::to_string(sum));
         }
 
-        // Generate agents based on the probabilities from agent taxonomy
-        for (const auto& agentType : agentTypeAttributes) {
+        // Number of agents per type based on the probabilities from agent taxonomy, in name order
+        // so that agent indices (and random streams) do not depend on hashing
+        std::vector<std::pair<std::string, int>> typeCounts;
+        for (const auto& agentType : scenarioData->agentTypeAttributes) {
+            typeCounts.emplace_back(agentType.first, static_cast<int>(numAgents * agentType.second.probability));
+        }
+        std::sort(typeCounts.begin(), typeCounts.end());
 
-            // Calculate the number of agents of each type
-            int numAgentsPerType = numAgents * agentType.second.probability;
-            int currentNumAgents = 0;
-            
-            for (int i = 0; i < numAgentsPerType; ++i) {
-                
-                // Generate random positions
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_real_distribution<> disPosX(0, simulationWidth);
-                std::uniform_real_distribution<> disPosY(0, simulationHeight);
-                
-                Agent agent(agentType.second); // Initialize agent with attributes: map(type as string, AgentTypeAttributes)
-                
-                agent.agentId = generateUUID();
-                agent.sensorId = "0";
-                agent.type = agentType.first;
-                agent.color = stringToColor(agentType.second.color);
-                agent.priority = agentType.second.priority;
-                agent.bodyRadius = agentType.second.bodyRadius;
-                agent.lookAheadTime = agentType.second.lookAheadTime;
-
-                agent.setBufferZoneSize();
-                agent.initialPosition = sf::Vector2f(disPosX(gen), disPosY(gen));
-                agent.targetPosition = sf::Vector2f(disPosX(gen), disPosY(gen));
-                agent.position = agent.initialPosition;
-                agent.waypointDistance = waypointDistance; // -> TODO: Use taxonomy for waypoint distance
-                // agent.waypointColor = sf::Color::Red;
-                agent.calculateTrajectory(agent.waypointDistance);
-                agent.timestamp = timestamp; // Use simulation timestamp from initialization
-
-                agent.velocityMagnitude = generateRandomNumberFromTND(
-                    agentType.second.velocity.mu, agentType.second.velocity.sigma, 
-                    agentType.second.velocity.min, agentType.second.velocity.max
-                );
+        createAgents(typeCounts);
+    }    
+}
 
-                agent.calculateVelocity(agent.trajectory[1]);
-                agent.initialVelocity = agent.velocity;
-                agents.push_back(agent);
+// Create agents of several types: hot fields in parallel chunks, then handles and ids in bulk passes
+void Simulation::createAgents(const std::vector<std::pair<std::string, int>>& typeCounts) {
 
-                // Increment the number of agents
-                currentNumAgents++;
-            }
+    sim::Clock phaseClock;
+
+    // Index range of every type, with the per-type lookups done once
+    std::vector<AgentTypePlan> plans;
+    uint32_t numNewAgents = 0;
+    for (const auto& [type, count] : typeCounts) {
 
-            DEBUG_MSG("Number of agents per type " << agentType.first << ": " << currentNumAgents << " in " << agentType.second.color);
+        auto agentType = scenarioData->agentTypeAttributes.find(type);
+        if (agentType == scenarioData->agentTypeAttributes.end()) {
+            ERROR_MSG("Error: Unknown agent type '" << type << "'");
+            continue;
         }
-        DEBUG_MSG("Total number of agents: " << agents.size());
-    }    
+        if (count <= 0) {
+            continue;
+        }
+
+        plans.push_back({&agentType->first, &agentType->second, stringToColor(agentType->second.color), numNewAgents, numNewAgents + count});
+        numNewAgents += count;
+
+        DEBUG_MSG("Number of agents per type " << type << ": " << count << " in " << agentType->second.color);
+    }
+    agents.reserve(agents.size() + numNewAgents);
+    TIMING_MSG("Agent initialization: plan " << phaseClock.restart().asMilliseconds() << " ms");
+
+    // Hot fields in chunks of consecutive indices (agent i always draws from stream i, at any thread count)
+    // A distributed rank keeps the agents starting in its strip, with their population indices
+    size_t numChunks = (numNewAgents + agentChunkSize - 1) / agentChunkSize;
+    std::vector<std::vector<Agent>> chunks(numChunks);
+    std::vector<std::vector<uint32_t>> chunkIndices(numChunks);
+    {
+        ThreadPool threadPool(numThreads);
+        std::vector<std::future<void>> futures;
+        for (size_t chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex) {
+            futures.push_back(threadPool.enqueue([this, &plans, &chunks, &chunkIndices, chunkIndex, numNewAgents] {
+
+                uint32_t begin = static_cast<uint32_t>(chunkIndex * agentChunkSize);
+                uint32_t end = std::min<uint32_t>(numNewAgents, begin + agentChunkSize);
+                std::vector<Agent>& chunk = chunks[chunkIndex];
+                chunk.reserve(end - begin);
+                chunkIndices[chunkIndex].reserve(end - begin);
+
+                size_t planIndex = 0;
+                for (uint32_t index = begin; index < end; ++index) {
+                    while (index >= plans[planIndex].end) {
+                        ++planIndex;
+                    }
+                    Agent agent = createAgent(plans[planIndex], index);
+                    if (ownsPosition(agent.position)) {
+                        chunk.push_back(std::move(agent));
+                        chunkIndices[chunkIndex].push_back(index);
+                    }
+                }
+            }));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
+    TIMING_MSG("Agent initialization: " << numNewAgents << " agents in " << numChunks << " chunks on " << numThreads << " threads " << phaseClock.restart().asMilliseconds() << " ms");
+
+    // Move the chunks into the agent vector in index order
+    std::vector<size_t> chunkOffsets(numChunks);
+    for (size_t chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex) {
+        chunkOffsets[chunkIndex] = agents.size();
+        for (auto& agent : chunks[chunkIndex]) {
+            addAgent(std::move(agent));
+        }
+        std::vector<Agent>().swap(chunks[chunkIndex]);
+    }
+    TIMING_MSG("Agent initialization: handles " << phaseClock.restart().asMilliseconds() << " ms");
+
+    // Cold data: ids from their own streams, so they are reproducible for a seed as well
+    {
+        ThreadPool threadPool(numThreads);
+        std::vector<std::future<void>> futures;
+        for (size_t chunkIndex = 0; chunkIndex < numChunks; ++chunkIndex) {
+            futures.push_back(threadPool.enqueue([this, &chunkIndices, &chunkOffsets, chunkIndex] {
+
+                const std::vector<uint32_t>& indices = chunkIndices[chunkIndex];
+                for (size_t i = 0; i < indices.size(); ++i) {
+                    Philox4x32 generator(seed, RandomStream::id(RandomStream::Ids, indices[i]));
+                    generateUUID(agents[chunkOffsets[chunkIndex] + i].agentId, generator);
+                }
+            }));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
+    TIMING_MSG("Agent initialization: ids " << phaseClock.restart().asMilliseconds() << " ms");
+
+    DEBUG_MSG("Total number of agents: " << agents.size());
+}
+
+// Create one agent from its random stream (called concurrently, reads only configuration)
+Agent Simulation::createAgent(const AgentTypePlan& plan, uint32_t index) const {
+
+    const Agent::AgentTypeAttributes& attributes = *plan.attributes;
+    Philox4x32 generator(seed, RandomStream::id(RandomStream::Agents, index));
+
+    Agent agent(attributes);
+
+    agent.sensorId = "0";
+    agent.type = *plan.type;
+    agent.color = plan.color;
+    agent.priority = attributes.priority;
+    agent.bodyRadius = attributes.bodyRadius;
+    agent.lookAheadTime = attributes.lookAheadTime;
+
+    agent.setBufferZoneSize();
+    agent.initialPosition = sim::Vector2f(generator.uniform(0.0f, simulationWidth), generator.uniform(0.0f, simulationHeight));
+    agent.targetPosition = sim::Vector2f(generator.uniform(0.0f, simulationWidth), generator.uniform(0.0f, simulationHeight));
+    agent.position = agent.initialPosition;
+    agent.waypointDistance = waypointDistance; // -> TODO: Use taxonomy for waypoint distance
+    agent.calculateTrajectory(agent.waypointDistance);
+    agent.timestamp = timestamp; // Use simulation timestamp from initialization
+    agent.lastUpdateTick = clock.getTick();
+
+    agent.velocityMagnitude = generateRandomNumberFromTND(
+        attributes.velocity.mu, attributes.velocity.sigma, 
+        attributes.velocity.min, attributes.velocity.max, generator
+    );
+    agent.calculateVelocity(agent.trajectory[1]);
+    agent.initialVelocity = agent.velocity;
+    agent.noiseOffset = generator.uniform(0.0f, 256.0f);
+
+    return agent;
 }
 
 void Simulation::initializeRegions() {
@@ -311,15 +346,15 @@ void Simulation::initializeRegions() {
     if(config["regions"]) {
         for (const auto& regionType: config["regions"]) {
 
-            Region region = Region(regionTypeAttributes[regionType["type"].as<std::string>()]);
+            Region region = Region(scenarioData->regionTypeAttributes.at(regionType["type"].as<std::string>()));
 
             region.type = regionType["type"].as<std::string>();
-            sf::FloatRect area(
+            sim::FloatRect area(
                 {regionType["area"]["x"].as<float>(), regionType["area"]["y"].as<float>()},
                 {regionType["area"]["width"].as<float>(), regionType["area"]["height"].as<float>()}
             );
             region.area = area;
-            region.colorAlpha = sf::Color(
+            region.colorAlpha = sim::Color(
                 stringToColor(region.attributes.color).r,
                 stringToColor(region.attributes.color).g,
                 stringToColor(region.attributes.color).b,
@@ -331,9 +366,22 @@ void Simulation::initializeRegions() {
             DEBUG_MSG("New " << region.type << " region created at (" << region.area.position.x << ", " << region.area.position.y << ") with area (" << region.area.size.x << ", " << region.area.size.y << ")");
         }
     }
+
+    // Rasterize the regions for constant-time lookups
+    float regionIndexResolution = 1.0f;
+    if (config["simulation"]["region_index_resolution"]) {
+        regionIndexResolution = config["simulation"]["region_index_resolution"].as<float>();
+    }
+    regionIndex.build(regions, {simulationWidth, simulationHeight}, regionIndexResolution);
 }
 
 // Initialize the database connection
+// MongoDB driver instance, created once per process and shared by all simulations
+mongocxx::instance& Simulation::getMongoInstance() {
+    static mongocxx::instance instance; // Thread-safe initialization, destroyed after all clients
+    return instance;
+}
+
 void Simulation::initializeDatabase() {
 
     // Load the database configuration
@@ -344,6 +392,9 @@ void Simulation::initializeDatabase() {
     dbUri = "mongodb://" + dbHost + ":" + std::to_string(dbPort);
     clearDatabase = config["database"]["clear_database"].as<bool>();
 
+    // The driver must be initialized before the first client
+    getMongoInstance();
+
     // MongoDB URI
     mongocxx::uri uri(dbUri);
 
@@ -373,14 +424,14 @@ void Simulation::initializeSensors() {
         // Get the sensor type and frame rate
         std::string type = sensorNode["type"].as<std::string>();
         float frameRate = sensorNode["frame_rate"].as<float>();
-        sf::Color color = stringToColor(sensorNode["detection_area"]["color"].as<std::string>());
+        sim::Color color = stringToColor(sensorNode["detection_area"]["color"].as<std::string>());
         int alpha = sensorNode["detection_area"]["alpha"].as<float>() * 255;
-        sf::Color colorAlpha = sf::Color(color.r, color.g, color.b, alpha);
+        sim::Color colorAlpha = sim::Color(color.r, color.g, color.b, alpha);
         std::string databaseName = sensorNode["database"]["db_name"].as<std::string>();
         std::string collectionName = sensorNode["database"]["collection_name"].as<std::string>();
 
         // Define the detection area for the sensor
-        sf::FloatRect detectionArea(
+        sim::FloatRect detectionArea(
             {sensorNode["detection_area"]["x"].as<float>(), sensorNode["detection_area"]["y"].as<float>()},
             {sensorNode["detection_area"]["width"].as<float>(), sensorNode["detection_area"]["height"].as<float>()}
         );
@@ -389,7 +440,20 @@ void Simulation::initializeSensors() {
         if (type == "agent-based") {
             
             // Create the agent-based sensor and add to sensors vector
-            sensors.push_back(std::make_unique<AgentBasedSensor>(frameRate, detectionArea, databaseName, collectionName, client, sensorBuffer));
+            auto agentBasedSensor = std::make_unique<AgentBasedSensor>(frameRate, detectionArea, databaseName, collectionName, client, sensorBuffer);
+
+            // Compute the privacy metrics of the captured data online
+            if (sensorNode["privacy_metrics"] && sensorNode["privacy_metrics"]["enabled"].as<bool>()) {
+                const YAML::Node& privacyMetricsNode = sensorNode["privacy_metrics"];
+                agentBasedSensor->privacyMetrics = std::make_unique<PrivacyMetrics>(
+                    privacyMetricsNode["speed_bin_size"].as<float>(),
+                    privacyMetricsNode["position_bin_size"].as<float>(),
+                    privacyMetricsNode["time_window"].as<float>(),
+                    privacyMetricsNode["output"].as<std::string>()
+                );
+            }
+
+            sensors.push_back(std::move(agentBasedSensor));
             sensors.back()->scale = scale;
             sensors.back()->timestamp = timestamp;
 
@@ -448,8 +512,50 @@ void Simulation::initializeSensors() {
             bool showGrid = sensorNode["grid"]["show_grid"].as<bool>();
             int maxDepth = sensorNode["grid"]["max_depth"].as<int>();
 
-            // Create the grid-based sensor and add to sensors vector
-            sensors.push_back(std::make_unique<AdaptiveGridBasedSensor>(frameRate, detectionArea, cellSize, maxDepth, databaseName, collectionName, client, sensorBuffer));
+            // Create the grid-based sensor
+            auto adaptiveGridBasedSensor = std::make_unique<AdaptiveGridBasedSensor>(frameRate, detectionArea, cellSize, maxDepth, databaseName, collectionName, client, sensorBuffer);
+
+            // Set the split mode and the regions providing the privacy constraints
+            if (sensorNode["grid"]["split_mode"]) {
+                adaptiveGridBasedSensor->splitMode = sensorNode["grid"]["split_mode"].as<std::string>();
+            }
+            adaptiveGridBasedSensor->setRegionIndex(regionIndex, regions);
+
+            // Enable the windowed aggregation, the temporal bounds are used for cells outside of any region
+            if (sensorNode["aggregation"] && sensorNode["aggregation"]["enabled"].as<bool>()) {
+                AggregationManager& aggregationManager = adaptiveGridBasedSensor->getAggregationManager();
+                aggregationManager.enabled = true;
+                if (sensorNode["aggregation"]["temporal"]) {
+                    aggregationManager.defaultWindowHop = sensorNode["aggregation"]["temporal"]["min"].as<float>();
+                    aggregationManager.defaultWindowLength = sensorNode["aggregation"]["temporal"]["max"].as<float>();
+                }
+
+                // Insert the closed windows from a writer thread
+                if (sensorNode["aggregation"]["async_writer"] && sensorNode["aggregation"]["async_writer"].as<bool>()) {
+                    aggregationManager.startAsyncWriter(dbUri, databaseName, collectionName);
+                }
+
+                // Approximate counts and distinct agents with bounded memory
+                const YAML::Node& approximateNode = sensorNode["aggregation"]["approximate"];
+                if (approximateNode && approximateNode["enabled"].as<bool>()) {
+                    aggregationManager.approximate = true;
+                    if (approximateNode["epsilon"]) aggregationManager.sketchEpsilon = approximateNode["epsilon"].as<double>();
+                    if (approximateNode["delta"]) aggregationManager.sketchDelta = approximateNode["delta"].as<double>();
+                    if (approximateNode["precision"]) aggregationManager.sketchPrecision = approximateNode["precision"].as<int>();
+                }
+            }
+
+            // Maintain the roll-up cube for multi-resolution queries
+            if (sensorNode["aggregation"] && sensorNode["aggregation"]["rollup"] && sensorNode["aggregation"]["rollup"]["enabled"].as<bool>()) {
+                AggregationManager& aggregationManager = adaptiveGridBasedSensor->getAggregationManager();
+                aggregationManager.rollupEnabled = true;
+                if (sensorNode["aggregation"]["rollup"]["output"]) {
+                    aggregationManager.rollupOutput = sensorNode["aggregation"]["rollup"]["output"].as<std::string>();
+                }
+            }
+
+            // Add to sensors vector
+            sensors.push_back(std::move(adaptiveGridBasedSensor));
             sensors.back()->scale = scale;
             sensors.back()->timestamp = timestamp;
             
@@ -468,14 +574,14 @@ void Simulation::initializeSensors() {
 void Simulation::run() {
 
     // Initialize the clock
-    sf::Clock simulationClock;
+    sim::Clock simulationClock;
     simulationClock.restart();
 
     // Initialize the simulation timers
-    sf::Time writeBufferTime = sf::Time::Zero;
-    sf::Time totalWriteBufferTime = sf::Time::Zero;
-    sf::Time simulationUpdateTime = sf::Time::Zero;
-    sf::Time simulationStepTime = sf::Time::Zero;
+    sim::Time writeBufferTime = sim::Time::Zero;
+    sim::Time totalWriteBufferTime = sim::Time::Zero;
+    sim::Time simulationUpdateTime = sim::Time::Zero;
+    sim::Time simulationStepTime = sim::Time::Zero;
 
     // Set the initial time step
     currentSimulationTimeStep = timeStep;
@@ -487,9 +593,13 @@ void Simulation::run() {
         // Restart the clock
         simulationClock.restart();
         
-        // Write the agent current frame to the agent buffer
-        auto currentFramePtr = std::make_shared<agentFrameType>(timestamp, agents);
-        agentBuffer.write(currentFramePtr);
+        // Write the agent current frame to the agent buffer (no copy without a reader)
+        if (agentBuffer.discardFrames) {
+            agentBuffer.write(nullptr);
+        } else {
+            auto currentFramePtr = std::make_shared<agentFrameType>(timestamp, agents);
+            agentBuffer.write(currentFramePtr);
+        }
         
         // Swap the read and write buffers if the read agentBuffer is empty
         agentBuffer.swap();
@@ -502,16 +612,29 @@ void Simulation::run() {
         postData(agents);
 
         // Increment the time step
-        simulationTime += sf::seconds(timeStep);
+        clock.advance();
 
         // Update the agents
         update();
 
+        // Hand over agents to the neighbouring ranks and wait for all ranks to finish the frame
+        if (partition) {
+            exchangeAgents();
+            if (!partition->synchronize(clock.getTick(), agents.size())) {
+                break;
+            }
+        }
+
         // Update timestamp
-        timestamp = generateISOTimestamp(simulationTime, datetime);
+        timestamp = clock.getTimestamp();
         
         // Swap the sensor agentBuffer
         sensorBuffer.swap();
+
+        // Write a checkpoint at every checkpoint interval
+        if (checkpointInterval > 0 && clock.getTick() % checkpointInterval == 0) {
+            saveCheckpoint(checkpointOutput + "_" + std::to_string(clock.getTick()) + ".bin");
+        }
         
         // Update the simulation update time
         simulationUpdateTime += simulationClock.getElapsedTime() - writeBufferTime;
@@ -524,6 +647,11 @@ void Simulation::run() {
         simulationRealTime += simulationStepTime;
     }
 
+    // Report the last frame to the coordinator
+    if (partition) {
+        partition->finish(clock.getTick(), agents.size());
+    }
+
     // Signalize the simulation has finished so that the renderer can swap buffers if needed
     agentBuffer.stop.store(true);
     sensorBuffer.stop.store(true);
@@ -536,7 +664,7 @@ void Simulation::run() {
 
     // Print simulation statistics
     STATS_MSG("Total simulation wall time: " << simulationRealTime.asSeconds() << " seconds for " << agentBuffer.currentWriteFrameIndex << " frames");
-    STATS_MSG("Total simulation time: " << simulationTime.asSeconds() << " seconds" << " for " << numAgents << " agents");
+    STATS_MSG("Total simulation time: " << clock.getSeconds() << " seconds (" << clock.getTick() << " ticks)" << " for " << numAgents << " agents");
     STATS_MSG("Simulation speedup: " << (maxFrames * timeStep) / simulationRealTime.asSeconds());
     STATS_MSG("Frame rate: " << 1/(simulationRealTime.asSeconds() / agentBuffer.currentWriteFrameIndex));
     STATS_MSG("Average simulation update time: " << simulationUpdateTime.asSeconds() / agentBuffer.currentWriteFrameIndex);
@@ -550,64 +678,1010 @@ void Simulation::update() {
     for (auto& sensor : sensors) {
 
         // sensor->update(agents, timeStep, simulationTime, datetime);
-        sensor->update(agents, timeStep, timestamp);
+        sensor->update(agents, clock);
         // sensor->printData();
         sensor->postData();
         // sensor->postAggregatedData();
     }
 
     // Update timestamp
-    timestamp = generateISOTimestamp(simulationTime, datetime);
+    timestamp = clock.getTimestamp();
     
-    // Clear the grid
+    // Clear the grid and the agents due for a velocity update
     collisionGrid.clear();
+    velocityBatch.agents.clear();
+
+    // Add the agents arriving in this frame
+    if (!spawnSources.empty()) {
+        spawnAgents();
+    }
+
+    // Advance the agents of the neighbouring ranks like the own agents
+    for (auto& ghost : remoteGhosts) {
+        ghost.position += ghost.velocity * timeStep;
+    }
+
+    // Areas in which agents are updated at full detail
+    updateObservedAreas();
+
+    // Large areas are updated tile by tile
+    if (!tiles.empty()) {
+        updateTiles();
+        updateSleep();
+        return;
+    }
 
     // Loop through all agents and update their positions
-    for(auto agent = agents.begin(); agent != agents.end();) {
+    for(size_t index = 0; index < agents.size();) {
+
+        Agent* agent = &agents[index];
+
+        // Sleeping agents are skipped until woken, neighbour queries still see them
+        if (!agent->isActive) {
+            collisionGrid.addStatic(agent);
+            ++index;
+            continue;
+        }
 
          // Check if agent is out of bounds
         if (agent->position.x > simulationWidth + agent->bodyRadius || agent->position.x < -agent->bodyRadius ||
             agent->position.y > simulationHeight + agent->bodyRadius || agent->position.y < -agent->bodyRadius) {
             
-            // Remove the agent from the vector and update the iterator
-            agent = agents.erase(agent); // Increases agent iterator if erased
+            // Remove the agent, the last agent takes its index and is updated next
+            removeAgent(index);
         } 
         else {
 
-            // Assign the agent to the correct grid cell
-            collisionGrid.addAgent(&(*agent));
+            // Agents outside every observed area take coarse steps
+            if (updateBackground(*agent)) {
+                collisionGrid.addStatic(agent);
+                ++index;
+                continue;
+            }
+
+            // Stopped agents without motion nearby fall asleep after the frame
+            if (shouldSleep(*agent)) {
+                sleepCandidates.push_back(index);
+                collisionGrid.addStatic(agent);
+                ++index;
+                continue;
+            }
+
+            // Assign the agent to the correct grid cell (removals only move agents not yet visited)
+            collisionGrid.addAgent(agent);
 
             // Reset collision state at the start of each frame for each agent
             agent->resetCollisionState();
             
-            // Update the agent position
-            agent->updatePosition(timeStep);
+            // Update the agent position (including the ticks skipped in the background)
+            agent->updatePosition(getUpdateTime(*agent));
 
             // Update the agent timestamp to new timestamp
             agent->timestamp = timestamp;
 
-            // Only update velocity if the agent is not stopped
+            // Only update velocity if the agent is not stopped (batched after the loop)
             if(!agent->stopped) {
-                agent->updateVelocity(timeStep, simulationRealTime);
+                agent->stoppedFrameCounter = 0;
+                velocityBatch.agents.push_back(index);
             }
             else {
-                if(!agent->collisionPredicted) {
-                    agent->resume(agents);
-                // agent->updateVelocity(timeStep, simulationRealTime);
-                }
+                resumeCandidates.push_back(index);
             }
-            ++agent;
+            ++index;
         }
     }
 
-    // Collision detection using grid
+    // Fluctuate the velocities of the moving agents
+    updateVelocities(velocityBatch);
+
+    // Collision detection using grid, including the agents of the neighbouring ranks
+    for (auto& ghost : remoteGhosts) {
+        collisionGrid.addGhost(&ghost);
+    }
     collisionGrid.checkCollisions();
+    checkObstacleCollisions(velocityBatch.agents, resumeCandidates, obstacleSweeps);
+
+    // Stopped agents without a predicted collision resume if their place is free
+    resumeAgents(resumeCandidates, SpatialQuery(collisionGrid));
+    resumeCandidates.clear();
+
+    // Put agents to sleep and wake sleepers near motion
+    updateSleep();
+}
+
+// Add an agent with a new handle
+void Simulation::addAgent(Agent agent) {
+
+    agent.handle = agentHandles.create(static_cast<uint32_t>(agents.size()));
+    agents.push_back(std::move(agent));
+}
+
+// Remove an agent in O(1) by moving the last agent into its place
+void Simulation::removeAgent(size_t index) {
+
+    agentHandles.release(agents[index].handle);
+
+    // Keep the agent's buffers for a later arrival
+    if (recycleAgents) {
+        agentPool.push_back(std::move(agents[index]));
+    }
+
+    if (index + 1 != agents.size()) {
+        agents[index] = std::move(agents.back());
+        agentHandles.relocate(agents[index].handle, static_cast<uint32_t>(index));
+    }
+    agents.pop_back();
+}
+
+// Spawn sources, corridors and preallocated buffers of the continuous scenario
+void Simulation::initializeSpawning() {
+
+    // One Poisson source per agent type with a spawn rate
+    for (const auto& [type, attributes] : scenarioData->agentTypeAttributes) {
+        if (attributes.spawnRate > 0.0f) {
+            spawnSources.push_back({type, attributes.spawnRate, 0.0f});
+        }
+    }
+    if (spawnSources.empty()) {
+        ERROR_MSG("Error: Continuous scenario without any agent type with a spawn_rate");
+        return;
+    }
+
+    // First arrivals, in type name order for a reproducible arrival sequence
+    std::sort(spawnSources.begin(), spawnSources.end(), [](const SpawnSource& a, const SpawnSource& b) { return a.type < b.type; });
+    spawnGenerator = Philox4x32(seed, RandomStream::id(RandomStream::Spawning, 0));
+    for (auto& source : spawnSources) {
+        source.nextSpawnTime = spawnGenerator.exponential(source.rate);
+    }
+
+    // Start corridors spawn agents, end corridors receive them (edges of the simulation area otherwise)
+    if (config["corridors"] && config["corridors"].IsSequence()) {
+        for (const auto& corridor : config["corridors"]) {
+            sim::FloatRect area(
+                {corridor["position"][0].as<float>(), corridor["position"][1].as<float>()},
+                {corridor["width"].as<float>(), corridor["height"].as<float>()}
+            );
+            std::string type = corridor["type"].as<std::string>();
+            if (type == "start") {
+                startCorridors.push_back(area);
+            } else if (type == "end") {
+                endCorridors.push_back(area);
+            }
+        }
+    }
+
+    // Reserve the population cap so that steady-state spawning does not allocate
+    recycleAgents = true;
+    agents.reserve(numAgents);
+    agentPool.reserve(numAgents);
+
+    DEBUG_MSG("Continuous scenario: " << spawnSources.size() << " spawn sources, " << startCorridors.size() << " start corridors, " << endCorridors.size() << " end corridors");
+}
+
+// Add the arrivals of all sources up to the current simulation time
+void Simulation::spawnAgents() {
+
+    float currentTime = static_cast<float>(clock.getSeconds());
+    for (auto& source : spawnSources) {
+
+        while (source.nextSpawnTime <= currentTime) {
+
+            // Arrivals beyond the population cap are dropped (a distributed rank draws all arrivals to keep the stream in step)
+            if (partition || static_cast<int>(agents.size()) < numAgents) {
+                spawnAgent(source.type);
+            }
+            source.nextSpawnTime += spawnGenerator.exponential(source.rate);
+        }
+    }
+}
+
+// Spawn an agent of a type, reusing a pooled agent if available
+void Simulation::spawnAgent(const std::string& type) {
+
+    const Agent::AgentTypeAttributes& attributes = scenarioData->agentTypeAttributes.at(type);
+
+    // Start and target positions, in corridors or on opposite edges
+    sim::Vector2f start;
+    sim::Vector2f target;
+    if (!startCorridors.empty()) {
+        const sim::FloatRect& startArea = startCorridors[spawnGenerator.uniformIndex(startCorridors.size())];
+        start = {startArea.position.x + spawnGenerator.uniform() * startArea.size.x, startArea.position.y + spawnGenerator.uniform() * startArea.size.y};
+
+        if (!endCorridors.empty()) {
+            const sim::FloatRect& endArea = endCorridors[spawnGenerator.uniformIndex(endCorridors.size())];
+            target = {endArea.position.x + spawnGenerator.uniform() * endArea.size.x, endArea.position.y + spawnGenerator.uniform() * endArea.size.y};
+        } else {
+            target = {simulationWidth - start.x, simulationHeight - start.y};
+        }
+    } else {
+        float a = spawnGenerator.uniform();
+        float b = spawnGenerator.uniform();
+        switch (spawnGenerator.uniformIndex(4)) {
+            case 0: start = {0.0f, a * simulationHeight}; target = {simulationWidth, b * simulationHeight}; break;
+            case 1: start = {simulationWidth, a * simulationHeight}; target = {0.0f, b * simulationHeight}; break;
+            case 2: start = {a * simulationWidth, 0.0f}; target = {b * simulationWidth, simulationHeight}; break;
+            default: start = {a * simulationWidth, simulationHeight}; target = {b * simulationWidth, 0.0f}; break;
+        }
+    }
+
+    // Reuse a pooled agent (keeps its string capacity)
+    bool pooled = !agentPool.empty();
+    Agent agent = pooled ? std::move(agentPool.back()) : Agent(attributes);
+    if (pooled) {
+        agentPool.pop_back();
+        agent.reset(attributes);
+    }
+
+    generateUUID(agent.agentId);
+    agent.sensorId = "0";
+    agent.type = type;
+    agent.color = stringToColor(attributes.color);
+    agent.priority = attributes.priority;
+    agent.bodyRadius = attributes.bodyRadius;
+    agent.lookAheadTime = attributes.lookAheadTime;
+
+    agent.setBufferZoneSize();
+    agent.initialPosition = start;
+    agent.targetPosition = target;
+    agent.position = start;
+    agent.waypointDistance = waypointDistance;
+    agent.calculateTrajectory(agent.waypointDistance);
+    agent.timestamp = timestamp;
+    agent.lastUpdateTick = clock.getTick();
+
+    agent.velocityMagnitude = generateRandomNumberFromTND(
+        attributes.velocity.mu, attributes.velocity.sigma,
+        attributes.velocity.min, attributes.velocity.max, spawnGenerator
+    );
+    agent.calculateVelocity(agent.trajectory[1]);
+    agent.initialVelocity = agent.velocity;
+    agent.noiseOffset = spawnGenerator.uniform(0.0f, 256.0f);
+
+    // Arrivals in another rank's strip or beyond this rank's cap only advance the stream
+    if (partition && (!partition->owns(agent.position) || static_cast<int>(agents.size()) >= numAgents)) {
+        agentPool.push_back(std::move(agent));
+        return;
+    }
+
+    addAgent(std::move(agent));
+}
+
+// Tiles of the spatial decomposition, if configured
+void Simulation::initializeTiles() {
+
+    if (!config["simulation"]["tiles"]) {
+        return;
+    }
+    const YAML::Node& tileConfig = config["simulation"]["tiles"];
+    tileColumns = std::max(tileConfig["columns"] ? tileConfig["columns"].as<int>() : 1, 1);
+    tileRows = std::max(tileConfig["rows"] ? tileConfig["rows"].as<int>() : 1, 1);
+    float tileWidth = simulationWidth / tileColumns;
+    float tileHeight = simulationHeight / tileRows;
+
+    // The halo covers the collision neighbourhood unless set, and only reaches into adjacent tiles
+    tileHalo = tileConfig["halo"] ? tileConfig["halo"].as<float>() : collisionGridCellSize;
+    if (tileHalo > std::min(tileWidth, tileHeight)) {
+        ERROR_MSG("Warning: Tile halo of " << tileHalo << " m exceeds the tile size, reduced to " << std::min(tileWidth, tileHeight) << " m");
+        tileHalo = std::min(tileWidth, tileHeight);
+    }
+
+    // Tiles in row-major order with their adjacent tiles
+    tiles.reserve(tileColumns * tileRows);
+    for (int row = 0; row < tileRows; ++row) {
+        for (int column = 0; column < tileColumns; ++column) {
+            Tile& tile = tiles.emplace_back(sim::FloatRect({column * tileWidth, row * tileHeight}, {tileWidth, tileHeight}), tileHalo, collisionGridCellSize);
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int x = column + dx;
+                    int y = row + dy;
+                    if ((dx != 0 || dy != 0) && x >= 0 && x < tileColumns && y >= 0 && y < tileRows) {
+                        tile.neighbours.push_back(y * tileColumns + x);
+                    }
+                }
+            }
+        }
+    }
+
+    // One worker per tile up to the number of threads
+    if (numThreads > 1 && tiles.size() > 1) {
+        tilePool = std::make_unique<ThreadPool>(std::min(static_cast<size_t>(numThreads), tiles.size()));
+    }
+
+    DEBUG_MSG("Simulation: " << tileColumns << " x " << tileRows << " tiles with a " << tileHalo << " m halo");
+}
+
+// Tile that owns a position (positions outside the area belong to the nearest edge tile)
+uint32_t Simulation::getTileIndex(const sim::Vector2f& position) const {
+
+    int column = std::clamp(static_cast<int>(position.x / simulationWidth * tileColumns), 0, tileColumns - 1);
+    int row = std::clamp(static_cast<int>(position.y / simulationHeight * tileRows), 0, tileRows - 1);
+
+    return static_cast<uint32_t>(row * tileColumns + column);
+}
+
+// Run a function for every tile on the tile workers and wait for all of them
+void Simulation::forEachTile(const std::function<void(Tile&)>& function) {
+
+    if (!tilePool) {
+        for (auto& tile : tiles) {
+            function(tile);
+        }
+        return;
+    }
+
+    std::vector<std::future<void>> results;
+    results.reserve(tiles.size());
+    for (auto& tile : tiles) {
+        results.push_back(tilePool->enqueue([&function, &tile]() { function(tile); }));
+    }
+    for (auto& result : results) {
+        result.get();
+    }
+}
+
+// Order the agent vector by tile (stable counting sort) and remove the agents that left the area
+void Simulation::migrateAgents() {
+
+    size_t numTiles = tiles.size();
+    uint32_t removed = static_cast<uint32_t>(numTiles);
+
+    // Tile of every agent, the extra bucket collects the agents out of bounds
+    agentTiles.resize(agents.size());
+    tileCounts.assign(numTiles + 1, 0);
+    bool ordered = true;
+    for (size_t index = 0; index < agents.size(); ++index) {
+        const Agent& agent = agents[index];
+        uint32_t tileIndex = removed;
+        if (agent.position.x <= simulationWidth + agent.bodyRadius && agent.position.x >= -agent.bodyRadius &&
+            agent.position.y <= simulationHeight + agent.bodyRadius && agent.position.y >= -agent.bodyRadius) {
+            tileIndex = getTileIndex(agent.position);
+            ordered = ordered && index >= tiles[tileIndex].begin && index < tiles[tileIndex].end;
+        } else {
+            ordered = false;
+        }
+        agentTiles[index] = tileIndex;
+        ++tileCounts[tileIndex];
+    }
+
+    // Nothing crossed an edge, arrived or left
+    if (ordered) {
+        return;
+    }
+
+    // Index ranges of the tiles, the removed agents follow the last tile
+    size_t offset = 0;
+    for (size_t t = 0; t <= numTiles; ++t) {
+        size_t count = tileCounts[t];
+        tileCounts[t] = offset;
+        if (t < numTiles) {
+            tiles[t].begin = offset;
+            tiles[t].end = offset + count;
+        }
+        offset += count;
+    }
+
+    // Source index of every destination index (stable: agents keep their order within a tile)
+    migrationOrder.resize(agents.size());
+    for (size_t index = 0; index < agents.size(); ++index) {
+        migrationOrder[tileCounts[agentTiles[index]]++] = static_cast<uint32_t>(index);
+    }
+
+    // Rebuild the vector in tile order and update the handles
+    size_t numKept = tiles.back().end;
+    migrationBuffer.clear();
+    migrationBuffer.reserve(agents.capacity());
+    for (size_t position = 0; position < numKept; ++position) {
+        migrationBuffer.push_back(std::move(agents[migrationOrder[position]]));
+        agentHandles.relocate(migrationBuffer.back().handle, static_cast<uint32_t>(position));
+    }
+
+    // Release the agents that left the simulation area (kept for a later arrival if recycling)
+    for (size_t position = numKept; position < agents.size(); ++position) {
+        Agent& agent = agents[migrationOrder[position]];
+        agentHandles.release(agent.handle);
+        if (recycleAgents) {
+            agentPool.push_back(std::move(agent));
+        }
+    }
+
+    agents.swap(migrationBuffer);
+    migrationBuffer.clear();
+}
+
+// Update all tiles: migration, own agents, ghost exchange and collisions, each phase in parallel
+void Simulation::updateTiles() {
+
+    // Move agents that crossed a tile edge and remove those that left the simulation area
+    migrateAgents();
+
+    // Positions and velocities of each tile's own agents
+    forEachTile([this](Tile& tile) {
+
+        tile.noise.agents.clear();
+        tile.borderAgents.clear();
+        for (size_t index = tile.begin; index < tile.end; ++index) {
+
+            // Sleeping agents are skipped, background agents take coarse steps, stopped agents without motion nearby fall asleep after the frame
+            Agent& agent = agents[index];
+            if (!agent.isActive || updateBackground(agent)) continue;
+            if (shouldSleep(agent)) {
+                tile.sleepCandidates.push_back(index);
+                continue;
+            }
+
+            agent.resetCollisionState();
+            agent.updatePosition(getUpdateTime(agent));
+            agent.timestamp = timestamp;
+
+            // Only update velocity if the agent is not stopped (batched per tile)
+            if (!agent.stopped) {
+                agent.stoppedFrameCounter = 0;
+                tile.noise.agents.push_back(index);
+            } else {
+                tile.resumeCandidates.push_back(index);
+            }
+        }
+        updateVelocities(tile.noise);
+
+        // Agents within the halo width of an edge are ghosts of the neighbours
+        for (size_t index = tile.begin; index < tile.end; ++index) {
+
+            const sim::Vector2f& position = agents[index].position;
+            if (position.x < tile.bounds.position.x + tileHalo || position.x >= tile.bounds.position.x + tile.bounds.size.x - tileHalo ||
+                position.y < tile.bounds.position.y + tileHalo || position.y >= tile.bounds.position.y + tile.bounds.size.y - tileHalo) {
+                tile.borderAgents.push_back(index);
+            }
+        }
+    });
+
+    // Copy the neighbours' border agents (read-only, before any tile checks collisions)
+    forEachTile([this](Tile& tile) {
+        exchangeGhosts(tile);
+    });
+
+    // Collision detection per tile, against own agents and ghosts
+    forEachTile([this](Tile& tile) {
+
+        tile.collisionGrid.clear();
+        for (size_t index = tile.begin; index < tile.end; ++index) {
+            if (agents[index].isActive && !agents[index].isBackground) {
+                tile.collisionGrid.addAgent(&agents[index]);
+            } else {
+                tile.collisionGrid.addStatic(&agents[index]);
+            }
+        }
+        for (size_t g = 0; g < tile.numGhosts; ++g) {
+            tile.collisionGrid.addGhost(&tile.ghosts[g]);
+        }
+        tile.collisionGrid.checkCollisions();
+        checkObstacleCollisions(tile.noise.agents, tile.resumeCandidates, tile.obstacleSweeps);
+
+        // Stopped agents resume if their place is free (neighbour positions do not change in this phase)
+        resumeAgents(tile.resumeCandidates, SpatialQuery(tile.collisionGrid));
+        tile.resumeCandidates.clear();
+    });
+}
+
+// Copy the border agents of the adjacent tiles that lie within the tile's halo
+void Simulation::exchangeGhosts(Tile& tile) {
+
+    tile.numGhosts = 0;
+    for (int neighbour : tile.neighbours) {
+        for (size_t index : tiles[neighbour].borderAgents) {
+
+            const Agent& agent = agents[index];
+            if (!tile.haloBounds.contains(agent.position)) continue;
+
+            // Reuse the buffers of earlier ghosts
+            if (tile.numGhosts < tile.ghosts.size()) {
+                tile.ghosts[tile.numGhosts] = agent;
+            } else {
+                tile.ghosts.push_back(agent);
+            }
+            ++tile.numGhosts;
+        }
+    }
+
+    // Agents of the neighbouring ranks (copied as well, tiles must not share ghosts)
+    for (const Agent& agent : remoteGhosts) {
+
+        if (!tile.haloBounds.contains(agent.position)) continue;
+
+        if (tile.numGhosts < tile.ghosts.size()) {
+            tile.ghosts[tile.numGhosts] = agent;
+        } else {
+            tile.ghosts.push_back(agent);
+        }
+        ++tile.numGhosts;
+    }
+}
+
+// Strip and connections of this rank in a distributed run
+void Simulation::initializeDistributed() {
+
+    if (!config["distributed"]) {
+        return;
+    }
+
+    Distributed::Settings settings = Distributed::Settings::load(config);
+    int rank = config["distributed"]["rank"] ? config["distributed"]["rank"].as<int>() : 0;
+    partition = std::make_unique<DistributedPartition>(settings, rank, simulationWidth);
+
+    // Every rank writes its own checkpoints
+    checkpointOutput += "_rank" + std::to_string(rank);
+}
+
+// Exchange migrants and ghosts with the neighbouring ranks
+void Simulation::exchangeAgents() {
+
+    partition->exchange(agents, departures, arrivals, remoteGhosts);
+
+    // Departures in descending index order, so swap-and-pop only moves agents that stay
+    for (auto departure = departures.rbegin(); departure != departures.rend(); ++departure) {
+        removeAgent(*departure);
+    }
+    for (auto& agent : arrivals) {
+        addAgent(std::move(agent));
+    }
+    arrivals.clear();
+}
+
+// Whether a segment touches a rectangle (slab test)
+static bool segmentIntersects(const sim::FloatRect& area, const sim::Vector2f& start, const sim::Vector2f& end) {
+
+    const float origin[2] = {start.x, start.y};
+    const float direction[2] = {end.x - start.x, end.y - start.y};
+    const float low[2] = {area.position.x, area.position.y};
+    const float high[2] = {area.position.x + area.size.x, area.position.y + area.size.y};
+
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+    for (int axis = 0; axis < 2; ++axis) {
+        if (std::abs(direction[axis]) < 1e-9f) {
+            if (origin[axis] < low[axis] || origin[axis] > high[axis]) return false;
+            continue;
+        }
+        float t0 = (low[axis] - origin[axis]) / direction[axis];
+        float t1 = (high[axis] - origin[axis]) / direction[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax) return false;
+    }
+    return true;
+}
+
+// Sensor detection areas and the renderer's viewport, extended by the margin
+void Simulation::updateObservedAreas() {
+
+    if (lodInterval <= 1) {
+        return;
+    }
+
+    observedAreas.clear();
+    auto addArea = [this](const sim::FloatRect& area) {
+        observedAreas.emplace_back(sim::Vector2f(area.position.x - lodMargin, area.position.y - lodMargin),
+                                   sim::Vector2f(area.size.x + 2.0f * lodMargin, area.size.y + 2.0f * lodMargin));
+    };
+    for (const auto& sensor : sensors) {
+        addArea(sensor->detectionArea);
+    }
+    sim::FloatRect viewport;
+    if (agentBuffer.getViewport(viewport)) {
+        addArea(viewport);
+    }
+}
+
+// Whether an agent is in an observed area or reaches one before its next coarse step
+bool Simulation::isObserved(const Agent& agent) const {
+
+    if (lodInterval <= 1) {
+        return true;
+    }
+
+    // Straight path until the next coarse step (stopped agents resume with their initial velocity)
+    const sim::Vector2f& velocity = agent.stopped ? agent.initialVelocity : agent.velocity;
+    sim::Vector2f end = agent.position + velocity * (timeStep * static_cast<float>(lodInterval));
+    for (const auto& area : observedAreas) {
+        if (segmentIntersects(area, agent.position, end)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Coarse step of an agent outside every observed area, false if it needs a full update (called concurrently per tile)
+bool Simulation::updateBackground(Agent& agent) {
+
+    agent.isBackground = !isObserved(agent);
+    if (!agent.isBackground) {
+        return false;
+    }
+
+    // Every tick steps a share of the background agents, staggered by handle slot
+    if ((clock.getTick() + agent.handle.slot) % lodInterval == 0) {
+
+        // Integrate the skipped ticks without velocity noise, then resume without collision checks
+        agent.resetCollisionState();
+        agent.updatePosition(getUpdateTime(agent));
+        agent.resume();
+        agent.stoppedFrameCounter = 0;
+        agent.timestamp = timestamp;
+    }
+    return true;
+}
+
+// Time since the last position update of an agent, one time step unless it was in the background
+float Simulation::getUpdateTime(Agent& agent) {
+
+    uint64_t tick = clock.getTick();
+    uint64_t ticks = std::clamp<uint64_t>(tick - agent.lastUpdateTick, 1, lodInterval);
+    agent.lastUpdateTick = tick;
+
+    return static_cast<float>(ticks) * timeStep;
+}
+
+// Cell of the sleep bookkeeping (collision cells in simulation coordinates)
+sim::Vector2i Simulation::getSleepCell(const sim::Vector2f& position) const {
+
+    return sim::Vector2i(static_cast<int>(std::floor(position.x / collisionGridCellSize)), static_cast<int>(std::floor(position.y / collisionGridCellSize)));
+}
+
+// Whether an agent moved in the same or an adjacent cell in the last frame
+bool Simulation::isNearMotion(const sim::Vector2f& position) const {
+
+    sim::Vector2i cell = getSleepCell(position);
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            if (movingCells.count(sim::Vector2i(cell.x + dx, cell.y + dy)) > 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Count the frames a stopped agent waits, it may sleep once no agent moves nearby (called concurrently per tile)
+bool Simulation::shouldSleep(Agent& agent) {
+
+    if (sleepAfterFrames == 0 || !agent.stopped) {
+        return false;
+    }
+    return ++agent.stoppedFrameCounter >= sleepAfterFrames && !isNearMotion(agent.position);
+}
+
+// Put the candidates to sleep, then wake the sleepers next to motion and those due for a check
+void Simulation::updateSleep() {
+
+    if (sleepAfterFrames == 0) {
+        return;
+    }
+
+    for (size_t index : sleepCandidates) {
+        sleepAgent(index);
+    }
+    sleepCandidates.clear();
+    for (auto& tile : tiles) {
+        for (size_t index : tile.sleepCandidates) {
+            sleepAgent(index);
+        }
+        tile.sleepCandidates.clear();
+    }
+
+    // Cells with moving agents at the end of the frame
+    movingCells.clear();
+    auto addMovingCells = [this](Grid& grid) {
+        for (const auto& [cellIndex, cell] : grid.cells) {
+            for (const Agent* agent : cell.agents) {
+                if (!agent->stopped) {
+                    movingCells.insert(getSleepCell(agent->position));
+                }
+            }
+        }
+    };
+    if (tiles.empty()) {
+        addMovingCells(collisionGrid);
+    } else {
+        for (auto& tile : tiles) {
+            addMovingCells(tile.collisionGrid);
+        }
+    }
+    if (numSleeping == 0) {
+        return;
+    }
+
+    // Sleepers in or next to a cell with motion
+    for (const sim::Vector2i& cell : movingCells) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                auto sleepers = sleepGrid.find(sim::Vector2i(cell.x + dx, cell.y + dy));
+                if (sleepers == sleepGrid.end()) continue;
+                for (AgentHandle handle : sleepers->second) {
+                    Agent* agent = getAgent(handle);
+                    if (agent && !agent->isActive) {
+                        wakeAgent(*agent);
+                    }
+                }
+                sleepGrid.erase(sleepers);
+            }
+        }
+    }
+
+    // Sleepers due for a check of their way (entries of agents woken earlier are skipped, also if they fell asleep again)
+    uint64_t tick = clock.getTick();
+    while (!sleepQueue.empty() && sleepQueue.front().first <= tick) {
+        auto [wakeTick, handle] = sleepQueue.front();
+        sleepQueue.pop_front();
+        Agent* agent = getAgent(handle);
+        if (!agent || agent->isActive || agent->wakeTick != wakeTick) continue;
+
+        std::vector<AgentHandle>& sleepers = sleepGrid[getSleepCell(agent->position)];
+        auto entry = std::find(sleepers.begin(), sleepers.end(), agent->handle);
+        if (entry != sleepers.end()) {
+            *entry = sleepers.back();
+            sleepers.pop_back();
+        }
+        wakeAgent(*agent);
+    }
+}
+
+void Simulation::sleepAgent(size_t index) {
+
+    Agent& agent = agents[index];
+    agent.isActive = false;
+    agent.wakeTick = clock.getTick() + maxSleepTicks;
+    sleepGrid[getSleepCell(agent.position)].push_back(agent.handle);
+    sleepQueue.emplace_back(agent.wakeTick, agent.handle);
+    ++numSleeping;
+}
+
+// Wake an agent, it resumes in the next frame if its way is free
+void Simulation::wakeAgent(Agent& agent) {
+
+    agent.isActive = true;
+    agent.stoppedFrameCounter = 0;
+    agent.lastUpdateTick = clock.getTick();
+    agent.timestamp = timestamp;
+    --numSleeping;
+}
+
+// Wake all agents and clear the sleep bookkeeping (e.g. after a restore)
+void Simulation::wakeAllAgents() {
+
+    for (auto& agent : agents) {
+        agent.isActive = true;
+    }
+    sleepGrid.clear();
+    sleepQueue.clear();
+    movingCells.clear();
+    sleepCandidates.clear();
+    numSleeping = 0;
+}
+
+// Resume the stopped agents without a predicted collision whose place is free (called concurrently per tile)
+void Simulation::resumeAgents(const std::vector<size_t>& candidates, const SpatialQuery& neighbours) {
+
+    for (size_t index : candidates) {
+        Agent& agent = agents[index];
+        if (!agent.collisionPredicted) {
+            agent.resume(neighbours);
+        }
+    }
+}
+
+// Stop the agents whose buffer zone hits an obstacle within the look-ahead time, stopped agents on the path they would resume on (called concurrently per tile)
+void Simulation::checkObstacleCollisions(const std::vector<size_t>& moving, const std::vector<size_t>& stopped, SweptCircleBatch& sweeps) {
+
+    const ObstacleIndex& obstacles = scenarioData->obstacleIndex;
+    if (obstacles.empty()) {
+        return;
+    }
+
+    // Agents with more clearance than their path and buffer zone need no sweep
+    const DistanceField& field = scenarioData->distanceField;
+    sweeps.clear();
+    auto addSweep = [&](size_t index, const sim::Vector2f& velocity) {
+        const Agent& agent = agents[index];
+        sim::Vector2f end = agent.position + velocity * agent.lookAheadTime;
+        if (!field.empty() && field.getClearance(agent.position) > agent.bufferZoneRadius + std::hypot(end.x - agent.position.x, end.y - agent.position.y)) {
+            return;
+        }
+        sweeps.add(index, agent.position, end, agent.bufferZoneRadius);
+    };
+    for (size_t index : moving) {
+        addSweep(index, agents[index].velocity);
+    }
+    for (size_t index : stopped) {
+        addSweep(index, agents[index].initialVelocity);
+    }
+    obstacles.sweep(sweeps);
+
+    for (size_t i = 0; i < sweeps.hit.size(); ++i) {
+        if (sweeps.hit[i] != ObstacleIndex::noHit) {
+            stopBeforeObstacle(agents[sweeps.ids[i]]);
+        }
+    }
+}
+
+// Signed distance to the nearest obstacle and the direction away from it (the maximum distance and no direction without a field)
+float Simulation::getObstacleClearance(const sim::Vector2f& position, sim::Vector2f& repulsion) const {
+
+    const DistanceField& field = scenarioData->distanceField;
+    if (field.empty()) {
+        repulsion = {0.0f, 0.0f};
+        return std::numeric_limits<float>::max();
+    }
+
+    float distance = field.getDistance(position, repulsion);
+    float length = std::hypot(repulsion.x, repulsion.y);
+    if (length > 0.0f) {
+        repulsion = {repulsion.x / length, repulsion.y / length};
+    }
+    return distance;
+}
+
+// Neighbour queries on this frame's collision grid (of the tile containing a position)
+SpatialQuery Simulation::getSpatialQuery(const sim::Vector2f& position) const {
+
+    if (tiles.empty()) {
+        return SpatialQuery(collisionGrid);
+    }
+    return SpatialQuery(tiles[getTileIndex(position)].collisionGrid);
+}
+
+// Agent of a handle, nullptr if the agent has left the simulation
+Agent* Simulation::getAgent(AgentHandle handle) {
+
+    int index = agentHandles.getIndex(handle);
+
+    return index < 0 ? nullptr : &agents[index];
+}
+
+// Write the simulation state after the current tick
+bool Simulation::saveCheckpoint(const std::string& path) const {
+
+    CheckpointWriter writer(path);
+
+    // Clock, frame index and random streams
+    writer.write(agentBuffer.currentWriteFrameIndex.load());
+    writer.write(clock);
+    writer.write(simulationRealTime.asMicroseconds());
+    writer.write(seed);
+    writer.write(spawnGenerator);
+    writer.write(velocityNoise);
+
+    // Arrival processes of the continuous scenario
+    writer.write(static_cast<uint64_t>(spawnSources.size()));
+    for (const auto& source : spawnSources) {
+        writer.write(source.type);
+        writer.write(source.rate);
+        writer.write(source.nextSpawnTime);
+    }
+
+    // Agents and their handles
+    agentHandles.save(writer);
+    writer.write(static_cast<uint64_t>(agents.size()));
+    for (const auto& agent : agents) {
+        agent.save(writer);
+    }
+
+    // Sensor states in configuration order
+    writer.write(static_cast<uint64_t>(sensors.size()));
+    for (const auto& sensor : sensors) {
+        sensor->saveState(writer);
+    }
+
+    if (!writer.good()) {
+        ERROR_MSG("Error: Could not write checkpoint " << path);
+        return false;
+    }
+    STATS_MSG("Checkpoint at tick " << clock.getTick() << ": " << agents.size() << " agents written to " << path);
+    return true;
+}
+
+// Replace the simulation state by a checkpoint of a run with the same configuration
+bool Simulation::loadCheckpoint(const std::string& path) {
+
+    CheckpointReader reader(path);
+    if (!reader.good()) {
+        return false;
+    }
+
+    // Clock, frame index and random streams
+    size_t frameIndex = 0;
+    SimulationClock checkpointClock;
+    int64_t realTime = 0;
+    reader.read(frameIndex);
+    reader.read(checkpointClock);
+    reader.read(realTime);
+    if (!reader.good() || checkpointClock.getTickMicroseconds() != clock.getTickMicroseconds()) {
+        ERROR_MSG("Error: Checkpoint " << path << " has a different time step than the configuration");
+        return false;
+    }
+    reader.read(seed);
+    reader.read(spawnGenerator);
+    reader.read(velocityNoise);
+
+    // Arrival processes of the continuous scenario
+    spawnSources.resize(reader.readSize());
+    for (auto& source : spawnSources) {
+        reader.read(source.type);
+        reader.read(source.rate);
+        reader.read(source.nextSpawnTime);
+    }
+
+    // Agents and their handles
+    agentHandles.load(reader);
+    size_t numLoadedAgents = reader.readSize();
+    agents.clear();
+    agents.reserve(numLoadedAgents);
+    for (size_t i = 0; i < numLoadedAgents && reader.good(); ++i) {
+        agents.emplace_back(Agent::AgentTypeAttributes{});
+        agents.back().load(reader);
+    }
+    agentPool.clear();
+    wakeAllAgents();
+
+    // Sensor states, only if the configuration has the same sensors
+    uint64_t numSensors = reader.readSize();
+    if (numSensors != sensors.size()) {
+        ERROR_MSG("Error: Checkpoint " << path << " has " << numSensors << " sensors, the configuration " << sensors.size());
+        return false;
+    }
+    for (auto& sensor : sensors) {
+        sensor->loadState(reader);
+    }
+
+    if (!reader.good()) {
+        ERROR_MSG("Error: Checkpoint " << path << " is truncated or corrupt");
+        return false;
+    }
+
+    clock = checkpointClock;
+    timestamp = clock.getTimestamp();
+    if (reader.getVersion() < 2) {
+        for (auto& agent : agents) {
+            agent.lastUpdateTick = clock.getTick();
+        }
+    }
+    simulationRealTime = sim::microseconds(realTime);
+    agentBuffer.currentWriteFrameIndex = frameIndex;
+    STATS_MSG("Restored checkpoint " << path << " at tick " << clock.getTick() << " with " << agents.size() << " agents");
+    return true;
+}
+
+// Evaluate the velocity noise of all moving agents in two batches
+void Simulation::updateVelocities(VelocityNoiseBatch& batch) {
+
+    size_t count = batch.agents.size();
+    batch.x.resize(count);
+    batch.y.resize(count);
+    batch.time.resize(2 * count);
+    batch.out.resize(2 * count);
+
+    // Gather the noise coordinates, the second half samples the y component further along the time axis
+    float time = simulationRealTime.asSeconds();
+    for (size_t i = 0; i < count; ++i) {
+        const Agent& agent = agents[batch.agents[i]];
+        batch.x[i] = agent.position.x * agent.attributes.velocity.noiseScale;
+        batch.y[i] = agent.position.y * agent.attributes.velocity.noiseScale;
+        batch.time[i] = time + agent.noiseOffset;
+        batch.time[count + i] = time + agent.noiseOffset + 1000.0f;
+    }
+
+    velocityNoise.noise(batch.x.data(), batch.y.data(), batch.time.data(), batch.out.data(), count);
+    velocityNoise.noise(batch.x.data(), batch.y.data(), batch.time.data() + count, batch.out.data() + count, count);
+
+    // Apply the noise values mapped to [-1, 1]
+    for (size_t i = 0; i < count; ++i) {
+        agents[batch.agents[i]].applyVelocityNoise(batch.out[i] * 2.0f - 1.0f, batch.out[count + i] * 2.0f - 1.0f);
+    }
 }
 
 void Simulation::postMetadata() {
 
     // Get the current timestamp
-    timestamp = generateISOTimestamp(simulationTime, datetime);
+    timestamp = clock.getTimestamp();
 
     // Prepare a BSON document for the metadata
     bsoncxx::builder::stream::document document{};
@@ -0,0 +1,33 @@
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+#include "../include/SimulationClock.hpp"
+
+// Parse the start datetime once
+SimulationClock::SimulationClock(const std::string& datetime, float timeStep)
+    : tickMicroseconds(std::max<int64_t>(1, std::llround(static_cast<double>(timeStep) * 1e6))) {
+
+    if (datetime.empty()) {
+        epoch = std::chrono::system_clock::now();
+    } else {
+        std::tm dateTimeStart = {};
+        std::istringstream ss(datetime);
+        ss >> std::get_time(&dateTimeStart, "%Y-%m-%dT%H:%M:%S");
+        epoch = std::chrono::system_clock::from_time_t(std::mktime(&dateTimeStart));
+    }
+}
+
+// Ticks per period of a frequency in Hz (the first tick at or after the period)
+uint64_t SimulationClock::getTicksPerPeriod(double frequency) const {
+
+    if (frequency <= 0.0) {
+        return 1;
+    }
+
+    double ticks = 1e6 / (frequency * static_cast<double>(tickMicroseconds));
+
+    return std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(ticks - 1e-9)));
+}
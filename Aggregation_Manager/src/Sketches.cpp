@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../include/Sketches.hpp"
+
+/*** COUNT-MIN SKETCH ***/
+
+// Width e / epsilon and depth ln(1 / delta)
+CountMinSketch::CountMinSketch(double epsilon, double delta)
+    : width(static_cast<size_t>(std::ceil(std::exp(1.0) / epsilon))),
+      depth(static_cast<size_t>(std::ceil(std::log(1.0 / delta)))) {
+
+    width = std::max<size_t>(width, 1);
+    depth = std::max<size_t>(depth, 1);
+    counters.assign(width * depth, 0);
+}
+
+void CountMinSketch::add(uint64_t key, uint32_t count) {
+    for (size_t row = 0; row < depth; ++row) {
+        counters[row * width + getIndex(key, row)] += count;
+    }
+}
+
+// Minimum over all rows (never underestimates)
+uint32_t CountMinSketch::estimate(uint64_t key) const {
+
+    if (counters.empty()) {
+        return 0;
+    }
+
+    uint32_t minimum = std::numeric_limits<uint32_t>::max();
+    for (size_t row = 0; row < depth; ++row) {
+        minimum = std::min(minimum, counters[row * width + getIndex(key, row)]);
+    }
+
+    return minimum;
+}
+
+bool CountMinSketch::merge(const CountMinSketch& other) {
+
+    if (other.empty()) {
+        return true;
+    }
+    if (empty()) {
+        *this = other;
+        return true;
+    }
+    if (width != other.width || depth != other.depth) {
+        return false;
+    }
+
+    for (size_t i = 0; i < counters.size(); ++i) {
+        counters[i] += other.counters[i];
+    }
+
+    return true;
+}
+
+void CountMinSketch::clear() {
+    std::fill(counters.begin(), counters.end(), 0);
+}
+
+// Column of a key in a row, every row uses a differently seeded hash
+size_t CountMinSketch::getIndex(uint64_t key, size_t row) const {
+    return mixHash(key ^ mixHash(row)) % width;
+}
+
+/*** HYPERLOGLOG ***/
+
+HyperLogLog::HyperLogLog(int precision)
+    : precision(std::clamp(precision, 4, 18)),
+      registers(size_t{1} << this->precision, 0) {}
+
+void HyperLogLog::add(uint64_t key) {
+
+    uint64_t hash = mixHash(key);
+
+    // The first bits select the register, the rank is the position of the first 1 in the rest
+    size_t index = hash >> (64 - precision);
+    uint64_t remainder = hash << precision;
+    uint8_t rank = remainder ? static_cast<uint8_t>(__builtin_clzll(remainder) + 1) : static_cast<uint8_t>(64 - precision + 1);
+
+    registers[index] = std::max(registers[index], rank);
+}
+
+// Harmonic mean estimate with linear counting for small cardinalities
+double HyperLogLog::estimate() const {
+
+    if (registers.empty()) {
+        return 0.0;
+    }
+
+    double m = static_cast<double>(registers.size());
+    double alpha = registers.size() == 16 ? 0.673
+                 : registers.size() == 32 ? 0.697
+                 : registers.size() == 64 ? 0.709
+                 : 0.7213 / (1.0 + 1.079 / m);
+
+    double sum = 0.0;
+    int zeros = 0;
+    for (uint8_t value : registers) {
+        sum += std::ldexp(1.0, -value);
+        zeros += value == 0;
+    }
+
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / zeros);
+    }
+
+    return estimate;
+}
+
+bool HyperLogLog::merge(const HyperLogLog& other) {
+
+    if (other.empty()) {
+        return true;
+    }
+    if (empty()) {
+        *this = other;
+        return true;
+    }
+    if (precision != other.precision) {
+        return false;
+    }
+
+    for (size_t i = 0; i < registers.size(); ++i) {
+        registers[i] = std::max(registers[i], other.registers[i]);
+    }
+
+    return true;
+}
+
+void HyperLogLog::clear() {
+    std::fill(registers.begin(), registers.end(), 0);
+}
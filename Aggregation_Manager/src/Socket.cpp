@@ -0,0 +1,251 @@
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <utility>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../include/Socket.hpp"
+
+namespace {
+
+// Parsed endpoint: a Unix socket path or a TCP host and port
+struct Endpoint {
+    bool isUnix = false;
+    std::string path;
+    std::string host;
+    std::string port;
+};
+
+bool parseEndpoint(const std::string& endpoint, Endpoint& parsed) {
+
+    if (endpoint.rfind("unix:", 0) == 0) {
+        parsed.isUnix = true;
+        parsed.path = endpoint.substr(5);
+        return !parsed.path.empty() && parsed.path.size() < sizeof(sockaddr_un::sun_path);
+    }
+
+    std::string address = endpoint.rfind("tcp:", 0) == 0 ? endpoint.substr(4) : endpoint;
+    size_t colon = address.find_last_of(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    parsed.host = address.substr(0, colon);
+    parsed.port = address.substr(colon + 1);
+    return !parsed.port.empty();
+}
+
+sockaddr_un unixAddress(const std::string& path) {
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+} // namespace
+
+Socket::~Socket() {
+    close();
+}
+
+Socket::Socket(Socket&& other) noexcept
+    : descriptor(std::exchange(other.descriptor, -1)), unixPath(std::move(other.unixPath)) {
+    other.unixPath.clear();
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+
+    if (this != &other) {
+        close();
+        descriptor = std::exchange(other.descriptor, -1);
+        unixPath = std::move(other.unixPath);
+        other.unixPath.clear();
+    }
+    return *this;
+}
+
+void Socket::close() {
+
+    if (descriptor >= 0) {
+        ::close(descriptor);
+        descriptor = -1;
+    }
+    if (!unixPath.empty()) {
+        ::unlink(unixPath.c_str());
+        unixPath.clear();
+    }
+}
+
+// Listening socket on an endpoint (replaces a stale Unix socket file)
+Socket Socket::listen(const std::string& endpoint) {
+
+    Endpoint parsed;
+    if (!parseEndpoint(endpoint, parsed)) {
+        ERROR_MSG("Error: Invalid socket endpoint " << endpoint);
+        return Socket();
+    }
+
+    Socket socket;
+    if (parsed.isUnix) {
+        socket.descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address = unixAddress(parsed.path);
+        ::unlink(parsed.path.c_str());
+        if (socket.descriptor < 0 || ::bind(socket.descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ERROR_MSG("Error: Could not bind " << endpoint << ": " << std::strerror(errno));
+            return Socket();
+        }
+        socket.unixPath = parsed.path;
+    } else {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        addrinfo* result = nullptr;
+        if (::getaddrinfo(parsed.host.empty() || parsed.host == "*" ? nullptr : parsed.host.c_str(), parsed.port.c_str(), &hints, &result) != 0 || !result) {
+            ERROR_MSG("Error: Could not resolve " << endpoint);
+            return Socket();
+        }
+        socket.descriptor = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+        int reuse = 1;
+        ::setsockopt(socket.descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        bool bound = socket.descriptor >= 0 && ::bind(socket.descriptor, result->ai_addr, result->ai_addrlen) == 0;
+        ::freeaddrinfo(result);
+        if (!bound) {
+            ERROR_MSG("Error: Could not bind " << endpoint << ": " << std::strerror(errno));
+            return Socket();
+        }
+    }
+
+    if (::listen(socket.descriptor, 16) != 0) {
+        ERROR_MSG("Error: Could not listen on " << endpoint << ": " << std::strerror(errno));
+        return Socket();
+    }
+    return socket;
+}
+
+// Connection to an endpoint, retried while the other process starts up
+Socket Socket::connect(const std::string& endpoint, int attempts, int retryMilliseconds) {
+
+    Endpoint parsed;
+    if (!parseEndpoint(endpoint, parsed)) {
+        ERROR_MSG("Error: Invalid socket endpoint " << endpoint);
+        return Socket();
+    }
+
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+
+        if (attempt > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(retryMilliseconds));
+        }
+
+        Socket socket;
+        if (parsed.isUnix) {
+            socket.descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address = unixAddress(parsed.path);
+            if (socket.descriptor >= 0 && ::connect(socket.descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+                return socket;
+            }
+        } else {
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* result = nullptr;
+            if (::getaddrinfo(parsed.host.c_str(), parsed.port.c_str(), &hints, &result) != 0 || !result) {
+                continue;
+            }
+            socket.descriptor = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+            bool connected = socket.descriptor >= 0 && ::connect(socket.descriptor, result->ai_addr, result->ai_addrlen) == 0;
+            ::freeaddrinfo(result);
+            if (connected) {
+
+                // Small per-frame messages: no Nagle delay
+                int noDelay = 1;
+                ::setsockopt(socket.descriptor, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                return socket;
+            }
+        }
+    }
+
+    ERROR_MSG("Error: Could not connect to " << endpoint << " after " << attempts << " attempts");
+    return Socket();
+}
+
+// Next connection of a listening socket
+Socket Socket::accept() const {
+
+    int connection = ::accept(descriptor, nullptr, nullptr);
+    if (connection < 0) {
+        ERROR_MSG("Error: Could not accept a connection: " << std::strerror(errno));
+        return Socket();
+    }
+
+    // No-op on Unix sockets
+    int noDelay = 1;
+    ::setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return Socket(connection);
+}
+
+bool Socket::sendMessage(uint32_t type, const std::string& payload) {
+
+    uint64_t size = payload.size();
+    char header[sizeof(type) + sizeof(size)];
+    std::memcpy(header, &type, sizeof(type));
+    std::memcpy(header + sizeof(type), &size, sizeof(size));
+
+    return sendAll(header, sizeof(header)) && sendAll(payload.data(), payload.size());
+}
+
+bool Socket::receiveMessage(uint32_t& type, std::string& payload) {
+
+    uint64_t size = 0;
+    char header[sizeof(type) + sizeof(size)];
+    if (!receiveAll(header, sizeof(header))) {
+        return false;
+    }
+    std::memcpy(&type, header, sizeof(type));
+    std::memcpy(&size, header + sizeof(type), sizeof(size));
+
+    payload.resize(size);
+    return receiveAll(payload.data(), size);
+}
+
+bool Socket::sendAll(const char* data, size_t size) {
+
+    while (size > 0 && descriptor >= 0) {
+        ssize_t sent = ::send(descriptor, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) {
+            ERROR_MSG("Error: Socket send failed: " << std::strerror(errno));
+            close();
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return descriptor >= 0;
+}
+
+bool Socket::receiveAll(char* data, size_t size) {
+
+    while (size > 0 && descriptor >= 0) {
+        ssize_t received = ::recv(descriptor, data, size, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) {
+            if (received < 0) {
+                ERROR_MSG("Error: Socket receive failed: " << std::strerror(errno));
+            }
+            close();
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return descriptor >= 0;
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+#include "../include/SpatialQuery.hpp"
+
+// Agents whose position lies in a rectangle
+void SpatialQuery::findInRect(const sim::FloatRect& area, std::vector<const Agent*>& result) const {
+
+    result.clear();
+    forEachInRect(area, [&result](const Agent* agent) {
+        result.push_back(agent);
+        return true;
+    });
+}
+
+// Agents within a distance of a point
+void SpatialQuery::findInRadius(const sim::Vector2f& center, float radius, std::vector<const Agent*>& result, const Agent* exclude) const {
+
+    result.clear();
+    float radiusSquared = radius * radius;
+    sim::FloatRect area({center.x - radius, center.y - radius}, {2.0f * radius, 2.0f * radius});
+    forEachInRect(area, [&](const Agent* agent) {
+        float dx = agent->position.x - center.x;
+        float dy = agent->position.y - center.y;
+        if (agent != exclude && dx * dx + dy * dy <= radiusSquared) {
+            result.push_back(agent);
+        }
+        return true;
+    });
+}
+
+// The k agents closest to a point in increasing distance, searched in rings of cells around the point
+void SpatialQuery::findNearest(const sim::Vector2f& center, size_t k, std::vector<const Agent*>& result, const Agent* exclude) const {
+
+    result.clear();
+    if (k == 0 || grid->cells.empty()) {
+        return;
+    }
+
+    std::vector<std::pair<float, const Agent*>> candidates;
+    auto addCell = [&](const sim::Vector2i& cellIndex) {
+        auto cell = grid->cells.find(cellIndex);
+        if (cell == grid->cells.end()) return;
+        for (const auto* members : {&cell->second.agents, &cell->second.ghosts, &cell->second.statics}) {
+            for (const Agent* agent : *members) {
+                if (agent == exclude) continue;
+                float dx = agent->position.x - center.x;
+                float dy = agent->position.y - center.y;
+                candidates.emplace_back(dx * dx + dy * dy, agent);
+            }
+        }
+    };
+
+    // After ring r, every agent not yet seen is at least r cells away from the point
+    sim::Vector2i centerCell = grid->getGridCellIndex(center);
+    int maxRing = std::max(grid->width, grid->height) + std::max(std::abs(centerCell.x), std::abs(centerCell.y)) + 1;
+    for (int ring = 0; ring <= maxRing; ++ring) {
+
+        if (ring == 0) {
+            addCell(centerCell);
+        } else {
+            for (int d = -ring; d <= ring; ++d) {
+                addCell(sim::Vector2i(centerCell.x + d, centerCell.y - ring));
+                addCell(sim::Vector2i(centerCell.x + d, centerCell.y + ring));
+            }
+            for (int d = -ring + 1; d <= ring - 1; ++d) {
+                addCell(sim::Vector2i(centerCell.x - ring, centerCell.y + d));
+                addCell(sim::Vector2i(centerCell.x + ring, centerCell.y + d));
+            }
+        }
+
+        if (candidates.size() >= k) {
+            std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+            float reach = ring * grid->cellSize;
+            if (candidates[k - 1].first <= reach * reach) {
+                break;
+            }
+        }
+    }
+
+    // Closest k in increasing distance
+    size_t count = std::min(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(candidates[i].second);
+    }
+}
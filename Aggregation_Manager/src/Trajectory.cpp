@@ -0,0 +1,124 @@
+#include <cmath>
+
+#include "../include/Trajectory.hpp"
+#include "../include/Checkpoint.hpp"
+
+// Straight route with waypoints every spacing meters
+void Trajectory::setStraight(sim::Vector2f start, sim::Vector2f target, float spacing) {
+
+    polyline.clear();
+    this->start = start;
+    this->target = target;
+    this->spacing = spacing;
+
+    // Number of intermediate waypoints, rounded down
+    sim::Vector2f delta = target - start;
+    length = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+    numIntermediate = spacing > 0.0f ? static_cast<int>(std::floor(length / spacing)) : 0;
+
+    // Offset between waypoints along the route
+    direction = length > 0.0f ? delta / length : sim::Vector2f(0.0f, 0.0f);
+    step = direction * spacing;
+}
+
+// Routed path through explicit waypoints
+void Trajectory::setPolyline(const std::vector<sim::Vector2f>& waypoints) {
+
+    polyline = waypoints;
+    numIntermediate = -1;
+}
+
+void Trajectory::clear() {
+    polyline.clear();
+    numIntermediate = -1;
+}
+
+size_t Trajectory::size() const {
+
+    if (!polyline.empty()) {
+        return polyline.size();
+    }
+
+    return numIntermediate < 0 ? 0 : static_cast<size_t>(numIntermediate) + 2;
+}
+
+// Waypoint at an index, computed for straight routes
+sim::Vector2f Trajectory::operator[](size_t index) const {
+
+    if (!polyline.empty()) {
+        return polyline[index];
+    }
+    if (index == 0) {
+        return start;
+    }
+    if (index > static_cast<size_t>(numIntermediate)) {
+        return target;
+    }
+
+    return start + step * static_cast<float>(index);
+}
+
+// First waypoint with a positive dot product between (waypoint - position) and velocity
+int Trajectory::getNextWaypointIndex(sim::Vector2f position, sim::Vector2f velocity) const {
+
+    // Routed paths: scan the polyline
+    if (!polyline.empty()) {
+        for (size_t i = 0; i < polyline.size(); ++i) {
+            sim::Vector2f direction = polyline[i] - position;
+            if (direction.x * velocity.x + direction.y * velocity.y > 0.0f) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+    if (numIntermediate < 0) {
+        return -1;
+    }
+
+    // Straight routes: waypoint i lies at distance s_i along the route, its dot product is
+    // dot(start - position, velocity) + s_i * dot(direction, velocity)
+    sim::Vector2f offset = start - position;
+    float startDot = offset.x * velocity.x + offset.y * velocity.y;
+    float directionDot = direction.x * velocity.x + direction.y * velocity.y;
+
+    // Moving away from (or across) the route: only the start can be ahead
+    if (directionDot <= 0.0f) {
+        return startDot > 0.0f ? 0 : -1;
+    }
+
+    // Moving along the route: the first waypoint beyond the projected distance
+    float projected = -startDot / directionDot;
+    if (projected < 0.0f) {
+        return 0;
+    }
+    if (spacing > 0.0f) {
+        float index = std::floor(projected / spacing) + 1.0f;
+        if (index <= static_cast<float>(numIntermediate)) {
+            return static_cast<int>(index);
+        }
+    }
+
+    return length > projected ? numIntermediate + 1 : -1;
+}
+
+void Trajectory::save(CheckpointWriter& writer) const {
+    writer.write(start);
+    writer.write(target);
+    writer.write(direction);
+    writer.write(step);
+    writer.write(spacing);
+    writer.write(length);
+    writer.write(numIntermediate);
+    writer.write(polyline);
+}
+
+void Trajectory::load(CheckpointReader& reader) {
+    reader.read(start);
+    reader.read(target);
+    reader.read(direction);
+    reader.read(step);
+    reader.read(spacing);
+    reader.read(length);
+    reader.read(numIntermediate);
+    reader.read(polyline);
+}
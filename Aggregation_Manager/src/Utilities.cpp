@@ -12,6 +12,37 @@ std::string generateUUID() {
     return std::string(uuidStr);
 }
 
+// Generate a unique identifier into an existing string (no allocation once it holds 36 characters)
+void generateUUID(std::string& uuidString) {
+
+    uuid_t uuid;
+    uuid_generate(uuid);
+    char uuidStr[37];
+    uuid_unparse(uuid, uuidStr);
+
+    uuidString.assign(uuidStr, 36);
+}
+
+// Generate a version 4 UUID from a random stream (reproducible, thread-safe per stream)
+void generateUUID(std::string& uuidString, Philox4x32& generator) {
+
+    uuid_t uuid;
+    for (int i = 0; i < 16; i += 4) {
+        uint32_t bits = generator();
+        uuid[i] = static_cast<unsigned char>(bits);
+        uuid[i + 1] = static_cast<unsigned char>(bits >> 8);
+        uuid[i + 2] = static_cast<unsigned char>(bits >> 16);
+        uuid[i + 3] = static_cast<unsigned char>(bits >> 24);
+    }
+    uuid[6] = (uuid[6] & 0x0F) | 0x40; // Version 4
+    uuid[8] = (uuid[8] & 0x3F) | 0x80; // RFC 4122 variant
+
+    char uuidStr[37];
+    uuid_unparse(uuid, uuidStr);
+
+    uuidString.assign(uuidStr, 36);
+}
+
 // Generate a unique identifier for the agent
 std::string generateISOTimestamp() {
 
@@ -26,9 +57,9 @@ std::string generateISOTimestamp() {
 // Generate velocity from truncated normal distribution
 float generateRandomNumberFromTND(float mean, float stddev, float min, float max) {
 
-    // Generate normal distribution
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    // Generate normal distribution (one generator per thread)
+    static thread_local std::random_device rd;
+    static thread_local std::mt19937 gen(rd());
     std::normal_distribution<float> generateNormal(mean, stddev);
 
     // Generate random number until it falls within the specified range
@@ -42,25 +73,39 @@ float generateRandomNumberFromTND(float mean, float stddev, float min, float max
     return value;
 }
 
+// Generate from a truncated normal distribution with a given random stream (reproducible)
+float generateRandomNumberFromTND(float mean, float stddev, float min, float max, Philox4x32& generator) {
+
+    // Generate random number until it falls within the specified range
+    float value;
+    do {
+
+        value = generator.normal(mean, stddev);
+
+    } while (value < min || value > max);
+
+    return value;
+}
+
 // Generate a random velocity vector from a truncated normal distribution
-sf::Vector2f generateRandomVelocityVector(float mu, float sigma, float min, float max) {
+sim::Vector2f generateRandomVelocityVector(float mu, float sigma, float min, float max) {
     
     // Generate distribution for angle
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_real_distribution<float> disAngle(0.0, 2 * M_PI);
-    sf::Vector2f velocity;
+    sim::Vector2f velocity;
 
     // Generate random velocity magnitude
     float velocityMagnitude = generateRandomNumberFromTND(mu, sigma, min, max);
     float angle = disAngle(gen);
-    velocity = sf::Vector2f(velocityMagnitude * std::cos(angle), velocityMagnitude * std::sin(angle));
+    velocity = sim::Vector2f(velocityMagnitude * std::cos(angle), velocityMagnitude * std::sin(angle));
     
     return velocity;
 }
 
 // Generate a BSON Date (UTC) for the current simulation time.
-std::chrono::system_clock::time_point generateISOTimestamp(sf::Time simulationWallTime, const std::string& dateTimeString = "") {
+std::chrono::system_clock::time_point generateISOTimestamp(sim::Time simulationWallTime, const std::string& dateTimeString = "") {
     
     using namespace std::chrono;
 
@@ -155,29 +200,29 @@ bsoncxx::types::b_date generateBsonDate(const std::string& timestamp) {
     return bsoncxx::types::b_date(total_tp);
 }
 
-// Convert a string to an sf::Color object
-sf::Color stringToColor(std::string colorStr) {
-
-    // Mapping of color names to sf::Color objects
-    static const std::unordered_map<std::string, sf::Color> colorMap = {
-
-        {"red", sf::Color::Red},
-        {"green", sf::Color::Green},
-        {"blue", sf::Color::Blue},
-        {"black", sf::Color::Black},
-        {"white", sf::Color::White},
-        {"yellow", sf::Color::Yellow},
-        {"magenta", sf::Color::Magenta},
-        {"cyan", sf::Color::Cyan},
-        {"pink", sf::Color(255, 192, 203)},
-        {"brown", sf::Color(165, 42, 42)},
-        {"turquoise", sf::Color(64, 224, 208)},
-        {"gray", sf::Color(128, 128, 128)},
-        {"purple", sf::Color(128, 0, 128)},
-        {"violet", sf::Color(238, 130, 238)},
-        {"orange", sf::Color(198, 81, 2)},
-        {"indigo", sf::Color(75, 0, 130)},
-        {"grey", sf::Color(128, 128, 128)}
+// Convert a string to an sim::Color object
+sim::Color stringToColor(std::string colorStr) {
+
+    // Mapping of color names to sim::Color objects
+    static const std::unordered_map<std::string, sim::Color> colorMap = {
+
+        {"red", sim::Color::Red},
+        {"green", sim::Color::Green},
+        {"blue", sim::Color::Blue},
+        {"black", sim::Color::Black},
+        {"white", sim::Color::White},
+        {"yellow", sim::Color::Yellow},
+        {"magenta", sim::Color::Magenta},
+        {"cyan", sim::Color::Cyan},
+        {"pink", sim::Color(255, 192, 203)},
+        {"brown", sim::Color(165, 42, 42)},
+        {"turquoise", sim::Color(64, 224, 208)},
+        {"gray", sim::Color(128, 128, 128)},
+        {"purple", sim::Color(128, 0, 128)},
+        {"violet", sim::Color(238, 130, 238)},
+        {"orange", sim::Color(198, 81, 2)},
+        {"indigo", sim::Color(75, 0, 130)},
+        {"grey", sim::Color(128, 128, 128)}
     };
 
     // Convert to lowercase directly for faster comparison
@@ -194,10 +239,10 @@ sf::Color stringToColor(std::string colorStr) {
     if (colorStr.length() == 7 && colorStr[0] == '#') {
         int r, g, b;
         if (sscanf(colorStr.c_str(), "#%02x%02x%02x", &r, &g, &b) == 3) {
-            return sf::Color(r, g, b);
+            return sim::Color(r, g, b);
         }
     }
 
     std::cerr << "Warning: Unrecognized color string '" << colorStr << "'. Using black instead." << std::endl;
-    return sf::Color::Black;
+    return sim::Color::Black;
 }
\ No newline at end of file